@@ -0,0 +1,490 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file basicsimulation.h
+ * @brief Simulation loop, and simulations with statically bound scheduler
+ * and task calls
+ */
+
+#ifndef CORE_BASICSIMULATION_H
+#define CORE_BASICSIMULATION_H 1
+
+#include <core/simulation.h>
+#include <utils/tlogger.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <list>
+#include <sstream>
+#include <typeinfo>
+
+namespace tmssim {
+
+  /**
+   * @brief Simulation with statically bound scheduler and task calls
+   *
+   * In the simulation loop, all calls of the scheduler and of the task
+   * hooks go directly to the implementations in SchedulerT and TaskT
+   * instead of through the vtable, so the compiler can inline them
+   * where their definitions are visible. The scheduler must be exactly
+   * of type SchedulerT and all tasks exactly of type TaskT, use
+   * #matches to check this before construction.
+   */
+  template<class SchedulerT, class TaskT>
+  class BasicSimulation : public Simulation {
+  public:
+    /**
+     * @brief C'tor, see Simulation::Simulation
+     * @throw SimulationException if scheduler or tasks are not of the
+     * exact types (the simulation still takes ownership)
+     */
+    BasicSimulation(Taskset* _taskset, Scheduler* _scheduler,
+		    ExitCondition _exitCondition = 0xffffffff)
+      : Simulation(_taskset, _scheduler, _exitCondition)
+    {
+      if (!matches(_taskset, _scheduler)) {
+	throw SimulationException("BasicSimulation: scheduler or task types do not match");
+      }
+    }
+
+    virtual ~BasicSimulation() {}
+
+    virtual ExitCondition run(TmsTimeInterval steps) {
+      return runSteps<SchedulerT, TaskT>(steps);
+    }
+
+    virtual ExitCondition finalise() {
+      return finaliseSteps<SchedulerT, TaskT>();
+    }
+
+    virtual ExitCondition lockstepStep(const std::vector<size_t>& dueTasks) {
+      return stepWith<SchedulerT, TaskT>(dueTasks);
+    }
+
+    virtual ExitCondition lockstepAdvance(TmsTimeInterval steps) {
+      return advanceBy<SchedulerT>(steps);
+    }
+
+    virtual TmsTime getNextSchedulerEventTime() const {
+      return nextSchedulerEvent<SchedulerT>();
+    }
+
+    /**
+     * @return true if the scheduler is a SchedulerT and all tasks are
+     * TaskT objects (and not objects of subclasses)
+     */
+    static bool matches(const Taskset* taskset, const Scheduler* scheduler) {
+      if (typeid(*scheduler) != typeid(SchedulerT))
+	return false;
+      for (const Task* task: *taskset) {
+	if (typeid(*task) != typeid(TaskT))
+	  return false;
+      }
+      return true;
+    }
+
+  };
+
+
+  /*
+   * Simulation loop, shared by Simulation (with SchedulerT = Scheduler,
+   * TaskT = Task) and BasicSimulation.
+   */
+
+  template<class SchedulerT, class TaskT>
+  Simulation::ExitCondition Simulation::runSteps(TmsTimeInterval steps) {
+    if (finalised) {
+      throw SimulationException("Cannot run simulation as it is finalised already!");
+    }
+
+    /*
+    LOG(LOG_CLASS_SIMULATION) << "######## Continuing simulation with scheduler " << scheduler->getId();
+    LOG(LOG_CLASS_SIMULATION) << "\tAim are " << steps << " iterations";
+    */
+
+    Simulation::ExitCondition ec = 0;
+    TmsTime start = now;
+    TmsTime end = start + steps;
+
+    LOG(LOG_CLASS_SIMULATION) << "Simulate from " << start << " for " << steps << " steps until " << end;
+
+    nextStateCheck = startSteadyStateDetection();
+      
+    for ( ; now < end; ++now) {
+      if (now == nextStateCheck) {
+	nextStateCheck = checkSteadyState(end);
+	if (now >= end)
+	  break;
+      }
+      const unsigned long allocations = AllocationCounter::getCount();
+      LOG(LOG_CLASS_SIMULATION) << "T : " << now;
+
+      ec = initStep<SchedulerT, TaskT>();
+      if (ec != 0) {
+	LOG(LOG_CLASS_SIMULATION) << "InitStep failed in regular time step " << now << " (ec: " << ec << ")";
+	break;
+      }
+
+      doActivations<SchedulerT, TaskT>();
+
+      ec = doExecutions<SchedulerT, TaskT>();
+      if (ec != 0) {
+	LOG(LOG_CLASS_SIMULATION) << "Executions failed in regular time step " << now << " (ec: " << ec << ")";
+	break;
+      }
+
+      if (advanceMode == AM_EVENT) {
+	TmsTime next = getNextEventTime<SchedulerT>();
+	if (next > end)
+	  next = end;
+	if (next > nextStateCheck)
+	  next = nextStateCheck;
+	if (next > now + 1) {
+	  ++now;
+	  ec = doAdvance<SchedulerT>(next - now);
+	  if (ec != 0) {
+	    LOG(LOG_CLASS_SIMULATION) << "Advance failed in time step " << now << " (ec: " << ec << ")";
+	    break;
+	  }
+	  now = next - 1;
+	}
+      }
+      checkAllocations(allocations);
+    }
+    LOG(LOG_CLASS_SIMULATION) << "Totally simulated time: " << (now - start);
+    
+    
+    // Save the statistics in a other object
+    //storeStatistics(statistics);
+
+    /*
+    calculateStatistics();
+    stats.simulatedTime = now;
+    */
+    // store this one if intermediate results are requested
+    stats.success = ec == 0;
+    return ec;
+  }
+
+
+  template<class SchedulerT, class TaskT>
+  Simulation::ExitCondition Simulation::finaliseSteps() {
+    if (finalised) {
+      throw SimulationException("Simulation is already finalised!");
+    }
+    
+    Simulation::ExitCondition ec = 0;
+    while (SchedulerCalls<SchedulerT>::hasPendingJobs(scheduler)) {
+      ec = initStep<SchedulerT, TaskT>();
+      if (ec != 0) {
+	LOG(LOG_CLASS_SIMULATION) << "Executions failed in regular time step " << now;
+	break;
+      }
+      ec = doExecutions<SchedulerT, TaskT>();
+      ++now;
+      if (ec != 0) {
+	LOG(LOG_CLASS_SIMULATION) << "Executions failed in during cleanup in step " << now;
+	break;
+      }
+    }
+    
+    printExecStats(scheduler->getId());
+    printDelayCounters();
+
+    finalised = true;
+    
+    return ec;
+  }
+
+
+  template<class SchedulerT, class TaskT>
+  Simulation::ExitCondition Simulation::stepWith(const std::vector<size_t>& due) {
+    const unsigned long allocations = AllocationCounter::getCount();
+    LOG(LOG_CLASS_SIMULATION) << "T : " << now;
+
+    Simulation::ExitCondition ec = initStep<SchedulerT, TaskT>();
+    if (ec != 0) {
+      LOG(LOG_CLASS_SIMULATION) << "InitStep failed in regular time step " << now << " (ec: " << ec << ")";
+      return ec;
+    }
+
+    activateTasks<SchedulerT, TaskT>(due);
+
+    ec = doExecutions<SchedulerT, TaskT>();
+    if (ec != 0) {
+      LOG(LOG_CLASS_SIMULATION) << "Executions failed in regular time step " << now << " (ec: " << ec << ")";
+      return ec;
+    }
+    checkAllocations(allocations);
+    ++now;
+    return 0;
+  }
+
+
+  template<class SchedulerT>
+  Simulation::ExitCondition Simulation::advanceBy(TmsTimeInterval steps) {
+    const unsigned long allocations = AllocationCounter::getCount();
+    Simulation::ExitCondition ec = doAdvance<SchedulerT>(steps);
+    if (ec != 0) {
+      LOG(LOG_CLASS_SIMULATION) << "Advance failed in time step " << now << " (ec: " << ec << ")";
+      return ec;
+    }
+    checkAllocations(allocations);
+    now += steps;
+    return 0;
+  }
+
+
+  template<class SchedulerT, class TaskT>
+  Simulation::ExitCondition Simulation::initStep() {
+    ScheduleStat& scStat = scheduleStat;
+    scStat.cancelled.clear();
+    //LOG(LOG_CLASS_SIMULATION) << "initStep";
+    Simulation::ExitCondition myRv = 0;
+    int scrv = SchedulerCalls<SchedulerT>::initStep(scheduler, now, scStat);
+    if (scrv != 0 && ((exitCondition & Simulation::EC_INIT_STEP) != 0)) {
+      myRv = Simulation::EC_INIT_STEP;
+    }
+    if (myRv == 0 && scStat.cancelled.size() > 0) {
+      bool rv = true;
+      LOG(LOG_CLASS_SIMULATION) << "Have initStep cancellations!";
+      rv = performCancellations<TaskT>(scStat);
+      if (!rv && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
+	myRv = Simulation::EC_CANCEL;
+      }
+    }
+    //LOG(LOG_CLASS_SIMULATION) << "/initStep";
+    return myRv;
+  }
+
+  
+  template<class SchedulerT, class TaskT>
+  void Simulation::doActivations() {
+    // take all due tasks from the calendar, activate them in taskset order
+    dueTasks.clear();
+    while (!activationCalendar.empty() && activationCalendar.front().first <= now) {
+      std::pop_heap(activationCalendar.begin(), activationCalendar.end(), std::greater<CalendarEntry>());
+      dueTasks.push_back(activationCalendar.back().second);
+      activationCalendar.pop_back();
+    }
+    std::sort(dueTasks.begin(), dueTasks.end());
+
+    activateTasks<SchedulerT, TaskT>(dueTasks);
+    for (size_t i : dueTasks) {
+      scheduleActivation(i);
+    }
+  }
+
+
+  template<class SchedulerT, class TaskT>
+  void Simulation::activateTasks(const std::vector<size_t>& due) {
+    tDebug() << "\nActivations [" << now << "]";
+    //bool rv = false;
+    std::vector<Job*>& actList = activatedJobs;
+    actList.clear();
+
+    for (size_t i : due) {
+      Task* task = (*taskset)[i];
+      Job* job = NULL;
+      job = task->spawnJobAs<TaskT>(now);
+      if (job != NULL) {
+	actList.push_back(job);
+	//rv = true;
+      }
+    }
+    // all jobs of this step are handed to the scheduler at once
+    if (actList.size() == 1)
+      SchedulerCalls<SchedulerT>::enqueueJob(scheduler, actList.front());
+    else if (actList.size() > 1)
+      SchedulerCalls<SchedulerT>::enqueueJobs(scheduler, actList);
+
+    if (actList.size() > 0
+	&& (LOG_ACTIVE(LOG_CLASS_EXEC) || TLOG_ACTIVE(TLL_DEBUG))) {
+      std::ostringstream oss;
+      oss << "A@" << now << " :";
+      std::ostringstream osb;
+      osb << "\t";
+      //log << "A@" << now << " :";
+      for (std::vector<Job*>::iterator it = actList.begin(); it != actList.end(); ++it) {
+	oss << " {" << *(*it) << "}";
+	osb << *it << " ";
+      }
+      LOG(LOG_CLASS_EXEC) << oss.str();
+      tDebug() << osb.str();
+    }
+    //return rv;
+  }
+
+  
+  template<class SchedulerT, class TaskT>
+  Simulation::ExitCondition Simulation::doExecutions() {
+    tDebug() << "Executions [" << now << "]";
+
+    // Schedule
+    ScheduleStat& scStat = scheduleStat;
+    scStat.cancelled.clear();
+    int scrv = SchedulerCalls<SchedulerT>::schedule(scheduler, now, scStat);
+    if (scrv != 0) {
+      LOG(LOG_CLASS_SIMULATION) << "Schedule failed: " << scrv;
+      //return false;
+      if ((exitCondition & Simulation::EC_SCHEDULE) != 0)
+	return Simulation::EC_SCHEDULE;
+    }
+
+    
+    if (scStat.cancelled.size() > 0) {
+      bool rv = true;
+      LOG(LOG_CLASS_SIMULATION) << "Have schedule cancellations!";
+      rv = performCancellations<TaskT>(scStat);
+      if (!rv && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
+	return Simulation::EC_CANCEL;
+      }
+    }
+    
+    // Dispatch
+    Job* job = NULL;
+    DispatchStat dispStat;
+    job = SchedulerCalls<SchedulerT>::dispatch(scheduler, now, dispStat);
+    if (dispStat.idle) {
+      ++idleSteps;
+    }
+    if (LOG_ACTIVE(LOG_CLASS_EXEC)) {
+      std::ostringstream oss;
+      oss << "E@" << now << " : ";
+      if (dispStat.idle) {
+	oss << "I";
+      }
+      else {
+	if (dispStat.executed != NULL)
+	  oss << "{" << *dispStat.executed << "} ";
+	else
+	  oss << "EXEC FAIL";
+      }
+      if ((long int) job < 0) {
+	oss << "\tDispatching failed: " << (long int) job;
+      }
+      else if (job != NULL) {
+	// TODO: Task-Specific notification symbols
+	// TODO: match with \(([A-Z])(,[A-Z])*\)
+	oss << "(F";
+	if (dispStat.dlMiss) {
+	  oss << ",M";
+	}
+	oss << ") ";
+	LOG(LOG_CLASS_EXEC) << oss.str();
+      }
+      else {
+	LOG(LOG_CLASS_EXEC) << oss.str();
+      }
+    }
+    
+    if ((long int) job < 0) {
+      if ((exitCondition & Simulation::EC_DISPATCH) != 0)
+	return Simulation::EC_DISPATCH;
+    }
+    else if (job != NULL) { // equiv to dispStat->finished != NULL
+      assert(job == dispStat.finished);
+      Task *task = job->getTask();
+      task->completeJobAs<TaskT>(job, now);
+      return 0;
+    }
+    return 0;
+  }
+
+
+  template<class SchedulerT>
+  TmsTime Simulation::getNextEventTime() const {
+    TmsTime next = SchedulerCalls<SchedulerT>::getNextEventTime(scheduler, now);
+    if (!activationCalendar.empty() && activationCalendar.front().first < next)
+      next = activationCalendar.front().first;
+    return next;
+  }
+
+
+  template<class SchedulerT>
+  Simulation::ExitCondition Simulation::doAdvance(TmsTimeInterval steps) {
+    DispatchStat dispStat;
+    int rv = SchedulerCalls<SchedulerT>::advance(scheduler, now, steps, dispStat);
+    if (dispStat.idle) {
+      idleSteps += steps;
+    }
+    if (LOG_ACTIVE(LOG_CLASS_EXEC)) {
+      std::ostringstream oss;
+      oss << "E@" << now << "-" << (now + steps - 1) << " : ";
+      if (dispStat.idle) {
+	oss << "I";
+      }
+      else {
+	if (dispStat.executed != NULL)
+	  oss << "{" << *dispStat.executed << "} ";
+	else
+	  oss << "EXEC FAIL";
+      }
+      if (rv != 0) {
+	oss << "\tAdvancing failed: " << rv;
+      }
+      LOG(LOG_CLASS_EXEC) << oss.str();
+    }
+
+    if (rv != 0 && (exitCondition & Simulation::EC_DISPATCH) != 0) {
+      return Simulation::EC_DISPATCH;
+    }
+    return 0;
+  }
+
+
+  template<class TaskT>
+  bool Simulation::performCancellations(const ScheduleStat& scStat) {
+    bool rv = true;
+    int ctr = 0;
+    if (LOG_ACTIVE(LOG_CLASS_EXEC)) {
+      std::ostringstream oss;
+      oss << "C@" << now << " :";
+      for (std::vector<Job*>::const_iterator it = scStat.cancelled.begin(); it != scStat.cancelled.end(); ++it) {
+	oss << " {" << *(*it) << "}";
+      }
+      LOG(LOG_CLASS_EXEC) << oss.str();
+    }
+    for (std::vector<Job*>::const_iterator it = scStat.cancelled.begin(); it != scStat.cancelled.end(); ++it) {
+      Job* cjob = *it;
+      //cout << "\tcanceling job " << cjob << " " << *cjob;
+      Task *task = cjob->getTask();
+      rv &= task->cancelJobAs<TaskT>(cjob);
+      ctr++;
+    }
+    //assert(ctr <= CANCEL_SLOTS);
+    //++cancelCtr[ctr - 1];
+    ++cancelSteps;
+    //statPtr->addToCancelStepList(now);
+    return rv;
+    /*if (!rv) { // && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
+      return Simulation::EC_CANCEL;
+    }
+    else {
+      return 0;
+      }*/
+  }
+  
+
+} // NS tmssim
+
+#endif // !CORE_BASICSIMULATION_H
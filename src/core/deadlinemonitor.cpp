@@ -29,13 +29,15 @@
  */
 
 #include <core/deadlinemonitor.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 
 using namespace std;
 
 namespace tmssim {
 
-  DeadlineMonitor::DeadlineMonitor() {
+  DeadlineMonitor::DeadlineMonitor()
+    : jobs(Job::QUEUE_MONITOR) {
   }
 
 
@@ -43,27 +45,19 @@ namespace tmssim {
   }
 
   
-  void DeadlineMonitor::addJob(const Job* job) {
+  void DeadlineMonitor::addJob(Job* job) {
     if (job == NULL) {
       // might also throw some error
       return;
     }
-    list<const Job*>::iterator it = jobs.begin();
-    while ( it != jobs.end()
-	    && *it != NULL
-	    && (*it)->getLatestStartTime() <= job->getLatestStartTime()) {
-      it++;
-    }
-    jobs.insert(it, job);
+    jobs.push(job, job->getLatestStartTime());
   }
 
   
   const Job* DeadlineMonitor::check(TmsTime now) {
-    if (jobs.size() == 0)
-      return NULL;
-    const Job* job = jobs.front();
-    if (job->getLatestStartTime() < now) {
-      jobs.pop_front();
+    const Job* job = jobs.top();
+    if (job != NULL && job->getLatestStartTime() < now) {
+      jobs.pop();
       return job;
     }
     else {
@@ -74,44 +68,39 @@ namespace tmssim {
 
   const Job* DeadlineMonitor::jobExecuted(const Job* job) {
     //cout << "Recording execution of job " << *job << endl;
-    list<const Job*>::iterator it = jobs.begin();
-    while ( it != jobs.end() && *it != job ) {
-      it++;
-    }
-    if (it == jobs.end())
+    // job execution can only increase the latest start time
+    if (!jobs.increaseKey(job, job->getLatestStartTime()))
       return NULL; // finished job not found
-
-    // job execution can only increase the latest start time, so we need only
-    // to look at jobs that are at the back of the list
-    list<const Job*>::iterator itJob = it;
-    it++; // goto next
-
-    if ( it == jobs.end() || (*it)->getLatestStartTime() >= job->getLatestStartTime() ) {
-      return job;
-    }
-    // else we need to reorder...
-    it = jobs.erase(itJob);
-    while ( it != jobs.end() && *it != NULL
-	    && (*it)->getLatestStartTime() < job->getLatestStartTime() ) {
-      it++;
-    }
-    jobs.insert(it, job);
     return job;
   }
 
 
   const Job* DeadlineMonitor::removeJob(const Job* job) {
-    list<const Job*>::iterator it = jobs.begin();
-    while ( it != jobs.end() && *it != job ) {
-      it++;
-    }
-    if (it == jobs.end())
+    if (!jobs.remove(job))
       return NULL;
-    jobs.erase(it);
     //tDebug() << "DLMon removed job " << job << " " << *job;
     return job;
   }
 
+
+  TmsTime DeadlineMonitor::getNextCheckTime(const Job* except) const {
+    const Job* job = jobs.top();
+    if (job != NULL && job == except)
+      job = jobs.second();
+    if (job == NULL)
+      return TMS_TIME_MAX;
+    return job->getLatestStartTime() + 1;
+  }
+
+
+  void DeadlineMonitor::writeState(StateSnapshot& snapshot) const {
+    vector<const Job*> monitored;
+    jobs.getJobs(monitored);
+    snapshot.add(monitored.size());
+    for (const Job* job: monitored) {
+      snapshot.addJobRef(job);
+    }
+  }
   
 
 } // NS tmssim
@@ -28,15 +28,21 @@
 #define CORE_DEADLINEMONITOR_H 1
 
 #include <core/scobjects.h>
-#include <list>
+#include <core/jobheap.h>
 
 namespace tmssim {
 
+  class StateSnapshot;
+
   /**
    * @brief Deadline Monitor for use in scheduler implementations.
    * 
    * Pending deadline misses are identified as soon as the latest possible
-   * start time for job has elapsed.
+   * start time for job has elapsed. The jobs are kept in a JobHeap keyed
+   * by their latest start times, so #check takes O(1) if no job misses
+   * its deadline, and all other operations take O(log n). Jobs with
+   * equal latest start times are returned in the same order as from a
+   * list sorted by insertion.
    */
   class DeadlineMonitor {
   public:
@@ -46,8 +52,9 @@ namespace tmssim {
     
     /**
      * @brief Add job to the monitoring list
+     * @param job the job, must not be contained in another monitor
      */
-    void addJob(const Job* job);
+    void addJob(Job* job);
 
     
     /**
@@ -69,8 +76,8 @@ namespace tmssim {
      * @brief notify the monitor that a job was executed for some time,
      * but is not yet finished.
      *
-     * This function adjusts the job's latest starting time and, if
-     * necessary, reorders the monitoring list.
+     * This function adjusts the job's position after its latest
+     * starting time has increased.
      */
     const Job* jobExecuted(const Job *job);
 
@@ -83,13 +90,29 @@ namespace tmssim {
      */
     const Job* removeJob(const Job* job);
 
+
+    /**
+     * @brief Get the earliest time at which #check might return a job.
+     *
+     * @param except a job that shall not be considered, e.g. because it
+     * is being executed, and thus its latest starting time increases
+     * @return the time, or TMS_TIME_MAX if no other job is monitored
+     */
+    TmsTime getNextCheckTime(const Job* except = NULL) const;
+
+    /**
+     * @brief Write references to the monitored jobs in the order in
+     * which they would be returned, see Scheduler::writeState
+     */
+    void writeState(StateSnapshot& snapshot) const;
+
     
   private:
     /**
      * Contains current jobs ordered increasingly by their latest
      * starting times.
      */
-    std::list<const Job*> jobs;
+    JobHeap jobs;
   };
 
 } // NS tmssim
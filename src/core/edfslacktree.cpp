@@ -0,0 +1,248 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file edfslacktree.cpp
+ * @brief Implementation of the EDF slack tree
+ */
+
+#include <core/edfslacktree.h>
+
+#include <cassert>
+
+using namespace std;
+
+namespace tmssim {
+
+  /// Lateness of an empty subtree, small enough to never cause a miss
+  static const TmsTime NO_LATENESS = INT64_MIN / 4;
+
+
+  EdfSlackTree::EdfSlackTree()
+    : root(NIL), count(0), seq(0), prioState(2463534242u) {
+  }
+
+
+  void EdfSlackTree::insert(Job* job) {
+    assert(job->slackIndex == Job::NO_INDEX);
+    int n;
+    if (!freeNodes.empty()) {
+      n = freeNodes.back();
+      freeNodes.pop_back();
+    }
+    else {
+      n = nodes.size();
+      nodes.push_back(Node());
+      // both hold at most one entry per node, so they only grow together
+      // with the nodes
+      freeNodes.reserve(nodes.capacity());
+      stack.reserve(nodes.capacity());
+    }
+    Node& node = nodes[n];
+    node.job = job;
+    node.deadline = job->getAbsDeadline();
+    node.seq = seq++;
+    node.rem = job->getRemainingExecutionTime();
+    node.prio = nextPrio();
+    node.left = NIL;
+    node.right = NIL;
+    pull(n);
+    job->slackIndex = n;
+
+    int l, r;
+    split(root, n, false, l, r);
+    root = merge(merge(l, n), r);
+    ++count;
+  }
+
+
+  bool EdfSlackTree::remove(const Job* job) {
+    if (!contains(job))
+      return false;
+    int n = job->slackIndex;
+    int l, m, r;
+    split(root, n, false, l, r);
+    split(r, n, true, m, r);
+    assert(m == n);
+    root = merge(l, r);
+    nodes[n].job->slackIndex = Job::NO_INDEX;
+    nodes[n].job = NULL;
+    freeNodes.push_back(n);
+    --count;
+    return true;
+  }
+
+
+  void EdfSlackTree::update(const Job* job) {
+    if (!contains(job))
+      return;
+    updateRec(root, job->slackIndex);
+  }
+
+
+  bool EdfSlackTree::contains(const Job* job) const {
+    return job->slackIndex < nodes.size() && nodes[job->slackIndex].job == job;
+  }
+
+
+  void EdfSlackTree::clear() {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i].job != NULL) {
+	nodes[i].job->slackIndex = Job::NO_INDEX;
+	nodes[i].job = NULL;
+	freeNodes.push_back(i);
+      }
+    }
+    root = NIL;
+    count = 0;
+  }
+
+
+  Job* EdfSlackTree::firstMiss(TmsTime now) const {
+    // a job misses its deadline if now + (accumulated rem) > deadline
+    if (root == NIL || maxOf(root) + now <= 0)
+      return NULL;
+    int n = root;
+    TmsTime offset = 0;
+    for (;;) {
+      const Node& node = nodes[n];
+      if (node.left != NIL && offset + maxOf(node.left) + now > 0) {
+	n = node.left;
+	continue;
+      }
+      offset += sumOf(node.left) + node.rem;
+      if (offset - node.deadline + now > 0)
+	return node.job;
+      n = node.right;
+      assert(n != NIL);
+    }
+  }
+
+
+  Job* EdfSlackTree::front() const {
+    if (root == NIL)
+      return NULL;
+    int n = root;
+    while (nodes[n].left != NIL)
+      n = nodes[n].left;
+    return nodes[n].job;
+  }
+
+
+  void EdfSlackTree::toList(JobList& jobs) const {
+    jobs.clear();
+    stack.clear();
+    int n = root;
+    while (n != NIL || !stack.empty()) {
+      while (n != NIL) {
+	stack.push_back(n);
+	n = nodes[n].left;
+      }
+      n = stack.back();
+      stack.pop_back();
+      jobs.push_back(nodes[n].job);
+      n = nodes[n].right;
+    }
+  }
+
+
+  TmsTime EdfSlackTree::maxOf(int n) const {
+    return n == NIL ? NO_LATENESS : nodes[n].maxLateness;
+  }
+
+
+  void EdfSlackTree::pull(int n) {
+    Node& node = nodes[n];
+    TmsTime lsum = sumOf(node.left);
+    TmsTime own = lsum + node.rem;
+    node.sum = own + sumOf(node.right);
+    TmsTime m = own - node.deadline;
+    if (maxOf(node.left) > m)
+      m = maxOf(node.left);
+    if (node.right != NIL && own + maxOf(node.right) > m)
+      m = own + maxOf(node.right);
+    node.maxLateness = m;
+  }
+
+
+  void EdfSlackTree::split(int t, int key, bool keyLeft, int& l, int& r) {
+    if (t == NIL) {
+      l = r = NIL;
+      return;
+    }
+    bool goesLeft = (t == key) ? keyLeft : before(t, key);
+    if (goesLeft) {
+      split(nodes[t].right, key, keyLeft, nodes[t].right, r);
+      l = t;
+    }
+    else {
+      split(nodes[t].left, key, keyLeft, l, nodes[t].left);
+      r = t;
+    }
+    pull(t);
+  }
+
+
+  int EdfSlackTree::merge(int l, int r) {
+    if (l == NIL)
+      return r;
+    if (r == NIL)
+      return l;
+    if (nodes[l].prio > nodes[r].prio) {
+      nodes[l].right = merge(nodes[l].right, r);
+      pull(l);
+      return l;
+    }
+    else {
+      nodes[r].left = merge(l, nodes[r].left);
+      pull(r);
+      return r;
+    }
+  }
+
+
+  bool EdfSlackTree::updateRec(int t, int key) {
+    if (t == NIL)
+      return false;
+    bool found;
+    if (t == key) {
+      nodes[t].rem = nodes[t].job->getRemainingExecutionTime();
+      found = true;
+    }
+    else if (before(key, t)) {
+      found = updateRec(nodes[t].left, key);
+    }
+    else {
+      found = updateRec(nodes[t].right, key);
+    }
+    pull(t);
+    return found;
+  }
+
+
+  uint32_t EdfSlackTree::nextPrio() {
+    // xorshift32, the shape of the tree does not influence any results
+    prioState ^= prioState << 13;
+    prioState ^= prioState >> 17;
+    prioState ^= prioState << 5;
+    return prioState;
+  }
+
+} // NS tmssim
@@ -0,0 +1,157 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file edfslacktree.h
+ * @brief Incremental feasibility check of EDF schedules
+ */
+
+#ifndef CORE_EDFSLACKTREE_H
+#define CORE_EDFSLACKTREE_H 1
+
+#include <core/primitives.h>
+#include <core/job.h>
+#include <core/joblist.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Jobs in EDF order with incremental feasibility check.
+   *
+   * The tree keeps its jobs ordered by their absolute deadlines; jobs with
+   * equal deadlines are ordered by insertion, i.e. a new job is placed
+   * behind all jobs with the same deadline (like the sorted insertion into
+   * EDFScheduler::mySchedule). Each subtree stores the remaining execution
+   * time of its jobs and the maximum of (accumulated remaining execution
+   * time - deadline) over its jobs. Thus, the first job that would miss its
+   * deadline in the EDF schedule can be found in O(log n) (see
+   * #firstMiss), instead of the O(n) scan of
+   * EDFScheduler::checkEDFSchedule.
+   *
+   * The tree is a treap, insertion and removal take O(log n) (expected).
+   * The tree copies the remaining execution time of a job at insertion.
+   * If the job is executed, the owner must call #update.
+   * The position of a job is stored in the job itself, so a job can only
+   * be stored in one EdfSlackTree at a time.
+   */
+  class EdfSlackTree {
+  public:
+    EdfSlackTree();
+
+    /**
+     * @brief Insert a job behind all jobs with the same or an earlier
+     * deadline
+     * @param job the job, must not be contained in any EdfSlackTree
+     */
+    void insert(Job* job);
+
+    /**
+     * @brief Remove a job
+     * @param job the job
+     * @return true, if the job was contained in the tree
+     */
+    bool remove(const Job* job);
+
+    /**
+     * @brief Update the remaining execution time of a job, e.g. after
+     * it was executed.
+     * @param job the job
+     */
+    void update(const Job* job);
+
+    /**
+     * @return true, if the job is contained in this tree, O(1)
+     */
+    bool contains(const Job* job) const;
+
+    /**
+     * @brief Remove all jobs
+     */
+    void clear();
+
+    /**
+     * @brief Check the EDF schedule for feasibility, equivalent to
+     * EDFScheduler::checkEDFSchedule.
+     * @param now the time when execution of the schedule starts
+     * @return the first job that would miss its deadline, NULL if all
+     * jobs can keep their deadlines
+     */
+    Job* firstMiss(TmsTime now) const;
+
+    /**
+     * @return the job with the earliest deadline, NULL if the tree is empty
+     */
+    Job* front() const;
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Copy all jobs in EDF order to a list
+     * @param[out] jobs the previous contents of the list are removed
+     */
+    void toList(JobList& jobs) const;
+
+  private:
+    struct Node {
+      Job* job;
+      TmsTime deadline;
+      uint64_t seq; ///< insertion order, breaks ties between equal deadlines
+      TmsTime rem; ///< remaining execution time of the job
+      uint32_t prio; ///< treap priority
+      int left;
+      int right;
+      TmsTime sum; ///< remaining execution time of the subtree
+      TmsTime maxLateness; ///< max. (accumulated sum - deadline) in subtree
+    };
+
+    static const int NIL = -1;
+
+    bool before(int a, int b) const {
+      return nodes[a].deadline < nodes[b].deadline
+	|| (nodes[a].deadline == nodes[b].deadline && nodes[a].seq < nodes[b].seq);
+    }
+
+    TmsTime sumOf(int n) const { return n == NIL ? 0 : nodes[n].sum; }
+    TmsTime maxOf(int n) const;
+
+    void pull(int n);
+    void split(int t, int key, bool keyLeft, int& l, int& r);
+    int merge(int l, int r);
+    bool updateRec(int t, int key);
+    uint32_t nextPrio();
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    int root;
+    size_t count;
+    uint64_t seq;
+    uint32_t prioState;
+    mutable std::vector<int> stack; ///< for in-order traversal
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_EDFSLACKTREE_H */
@@ -31,6 +31,7 @@
 //#include <core/scobjects.h>
 #include <core/job.h>
 #include <core/task.h>
+#include <core/jobpool.h>
 
 #include <cassert>
 //#include <iostream>
@@ -44,15 +45,31 @@ namespace tmssim {
 
   Job::Job(Task* task, unsigned int jid, TmsTime _activationTime, TmsTimeInterval _executionTime, TmsTime _absDeadline, TmsPriority _priority)
     : myTask(task), jobId(jid), activationTime(_activationTime), executionTime(_executionTime), absDeadline(_absDeadline), priority(_priority),
-      etRemain(_executionTime), preemptions(0)
+      etRemain(_executionTime), preemptions(0), slackIndex(NO_INDEX)
   {
     assert(task != NULL);
+    for (int i = 0; i < QUEUE_SLOTS; ++i) {
+      queueHooks[i].queue = NULL;
+      queueHooks[i].index = NO_INDEX;
+      queueHooks[i].prev = NULL;
+      queueHooks[i].next = NULL;
+    }
     updateLatestStartTime();
   }
   
   
   Job::~Job() {
   }
+
+
+  void* Job::operator new(size_t size) {
+    return JobPool::allocate(size);
+  }
+
+
+  void Job::operator delete(void* ptr, size_t size) {
+    JobPool::release(ptr, size);
+  }
   
 
   TmsTime Job::getActivationTime(void) const {
@@ -80,7 +97,7 @@ namespace tmssim {
   }
 
   
-  TmsPriority Job::getPriority(){
+  TmsPriority Job::getPriority() const {
     return priority;
   }
 
@@ -92,6 +109,14 @@ namespace tmssim {
     else return false;
   }
 
+
+  bool Job::execSteps(UNUSED TmsTime now, TmsTimeInterval steps) {
+    etRemain -= steps;
+    updateLatestStartTime();
+    if (etRemain <= 0) return true;
+    else return false;
+  }
+
   
   TmsTime Job::getLatestStartTime(void) const {
     return latestStartTime;
@@ -27,6 +27,7 @@
 #ifndef CORE_JOB_H
 #define CORE_JOB_H 1
 
+#include <cstddef>
 #include <string>
 
 #include <core/primitives.h>
@@ -34,6 +35,7 @@
 namespace tmssim {
 
   class Task;
+  class JobQueue;
 
   /**
     @brief Representation of a job that must be executed.
@@ -55,13 +57,23 @@ namespace tmssim {
 	TmsPriority _priority);
     //Job(const Job& rhs);
     virtual ~Job();
+
+    /// @name Memory management
+    ///@{
+    /**
+     * Jobs (including subclasses) are allocated from the current
+     * #tmssim::JobPool, which is set by #tmssim::Task::spawnJob.
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+    ///@}
     
     TmsTime getActivationTime(void) const; ///< get activation time
     TmsTimeInterval getExecutionTime(void) const; ///< get execution time
     TmsTime getAbsDeadline(void) const; ///< get critial time
     TmsTimeInterval getRemainingExecutionTime(void) const; ///< get remaining execution time
     Task* getTask(void) const; ///< get owner task
-    TmsPriority getPriority(); ///< get (static) priority
+    TmsPriority getPriority() const; ///< get (static) priority
     TmsTime getLatestStartTime(void) const; ///< get latest start time
 
     bool isFeasible(TmsTime now) const;
@@ -69,6 +81,7 @@ namespace tmssim {
     void updateLatestStartTime(void);
     
     bool execStep(TmsTime now); ///< execute one step; @return true if remaining ET is zero
+    bool execSteps(TmsTime now, TmsTimeInterval steps); ///< execute several steps at once; @return true if remaining ET is zero
     void preempt(); ///< notification from scheduler - job is preempted
     void setPriority(TmsPriority p); ///< set static priority
     int getPreemptions() const; ///< get number of  preemptions
@@ -102,6 +115,22 @@ namespace tmssim {
     
     unsigned int getJobId(void) const { return jobId; }
 
+    /// Value of the container positions while the job is not stored
+    static const size_t NO_INDEX = (size_t) -1;
+
+    /**
+     * @brief The kinds of #tmssim::JobQueue that can contain a job at the
+     * same time, each one has its own position in the job, whichever
+     * container implements it
+     */
+    enum QueueSlot {
+      QUEUE_SCHEDULE, ///< the queue from which a scheduler executes jobs
+      QUEUE_READY, ///< all ready jobs, if a scheduler keeps them apart
+      QUEUE_MISSED, ///< jobs that missed their deadline, but still execute
+      QUEUE_MONITOR, ///< a #tmssim::DeadlineMonitor
+      QUEUE_SLOTS
+    };
+
   protected:
     Task* myTask; ///< owner task
     unsigned int jobId; ///< usually job number
@@ -112,6 +141,21 @@ namespace tmssim {
     TmsTimeInterval etRemain; ///< remaining execution time
     int preemptions; ///< count dispatch/schedule preemptions
     TmsTime latestStartTime; ///< latest start time
+
+  private:
+    size_t slackIndex; ///< position in a #tmssim::EdfSlackTree
+    /// Position in a #tmssim::JobQueue
+    struct QueueHook {
+      const JobQueue* queue; ///< the queue that contains the job, or NULL
+      size_t index; ///< JobHeap: heap index, JobPriorityQueue: bucket
+      Job* prev; ///< JobList, JobPriorityQueue: neighbours
+      Job* next;
+    };
+    QueueHook queueHooks[QUEUE_SLOTS];
+    friend class JobHeap;
+    friend class EdfSlackTree;
+    friend class JobPriorityQueue;
+    friend class JobList;
     
   public:
     friend std::ostream& operator << (std::ostream& ost, const Job& job);
@@ -0,0 +1,160 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobheap.cpp
+ * @brief Implementation of the indexed job heap
+ */
+
+#include <core/jobheap.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace tmssim {
+
+  JobHeap::JobHeap(Job::QueueSlot _slot)
+    : slot(_slot), seq(0), frontSeq(-1) {
+  }
+
+
+  void JobHeap::push(Job* job, TmsTime key) {
+    Job::QueueHook& h = job->queueHooks[slot];
+    assert(h.queue == NULL);
+    Entry e = { key, seq++, job };
+    heap.push_back(e);
+    h.queue = this;
+    h.index = heap.size() - 1;
+    siftUp(heap.size() - 1);
+  }
+
+
+  Job* JobHeap::second() const {
+    size_t n = heap.size();
+    if (n < 2)
+      return NULL;
+    size_t last = 1 + ARITY < n ? 1 + ARITY : n;
+    size_t best = 1;
+    for (size_t c = 2; c < last; ++c) {
+      if (before(heap[c], heap[best]))
+	best = c;
+    }
+    return heap[best].job;
+  }
+
+
+  Job* JobHeap::pop() {
+    if (heap.empty())
+      return NULL;
+    Job* job = heap.front().job;
+    removeAt(0);
+    return job;
+  }
+
+
+  bool JobHeap::remove(const Job* job) {
+    if (!contains(job))
+      return false;
+    removeAt(job->queueHooks[slot].index);
+    return true;
+  }
+
+
+  bool JobHeap::increaseKey(const Job* job, TmsTime key) {
+    if (!contains(job))
+      return false;
+    size_t i = job->queueHooks[slot].index;
+    assert(key >= heap[i].key);
+    if (key == heap[i].key)
+      return true;
+    heap[i].key = key;
+    heap[i].seq = frontSeq--;
+    siftDown(i);
+    return true;
+  }
+
+
+  bool JobHeap::contains(const Job* job) const {
+    return job->queueHooks[slot].queue == this;
+  }
+
+
+  void JobHeap::removeAt(size_t i) {
+    Job::QueueHook& h = heap[i].job->queueHooks[slot];
+    h.queue = NULL;
+    h.index = Job::NO_INDEX;
+    Entry last = heap.back();
+    heap.pop_back();
+    if (i < heap.size()) {
+      place(i, last);
+      if (i > 0 && before(heap[i], heap[(i - 1) / ARITY]))
+	siftUp(i);
+      else
+	siftDown(i);
+    }
+  }
+
+
+  void JobHeap::siftUp(size_t i) {
+    Entry e = heap[i];
+    while (i > 0) {
+      size_t parent = (i - 1) / ARITY;
+      if (!before(e, heap[parent]))
+	break;
+      place(i, heap[parent]);
+      i = parent;
+    }
+    place(i, e);
+  }
+
+
+  void JobHeap::siftDown(size_t i) {
+    Entry e = heap[i];
+    size_t n = heap.size();
+    for (;;) {
+      size_t first = i * ARITY + 1;
+      if (first >= n)
+	break;
+      size_t best = first;
+      size_t last = first + ARITY < n ? first + ARITY : n;
+      for (size_t c = first + 1; c < last; ++c) {
+	if (before(heap[c], heap[best]))
+	  best = c;
+      }
+      if (!before(heap[best], e))
+	break;
+      place(i, heap[best]);
+      i = best;
+    }
+    place(i, e);
+  }
+
+
+  void JobHeap::getJobs(std::vector<const Job*>& jobs) const {
+    std::vector<Entry> entries(heap.begin(), heap.end());
+    std::sort(entries.begin(), entries.end(), before);
+    for (const Entry& e: entries) {
+      jobs.push_back(e.job);
+    }
+  }
+
+} // NS tmssim
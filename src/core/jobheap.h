@@ -0,0 +1,150 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobheap.h
+ * @brief Indexed priority queue of jobs
+ */
+
+#ifndef CORE_JOBHEAP_H
+#define CORE_JOBHEAP_H 1
+
+#include <core/primitives.h>
+#include <core/job.h>
+#include <core/jobqueue.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Indexed d-ary min-heap of jobs, e.g. as ready queue.
+   *
+   * Each job is inserted with a key (e.g. its absolute deadline); jobs
+   * with equal keys are ordered by insertion (FIFO), like in a sorted
+   * list where new jobs are inserted behind all jobs with the same key.
+   * The position of a job is stored in the job itself, so removal of an
+   * arbitrary job takes O(log n), and membership can be tested in O(1).
+   * Thus, a job can only be stored in one JobQueue per Job::QueueSlot
+   * at a time.
+   */
+  class JobHeap : public JobQueue {
+  public:
+    /**
+     * @param _slot the position of the jobs that is used by this heap
+     */
+    explicit JobHeap(Job::QueueSlot _slot);
+
+    /**
+     * @brief Insert a job, O(log n)
+     * @param job the job, must not be contained in any JobQueue of this
+     * heap's slot
+     * @param key the sorting key, smallest key is at the top
+     */
+    void push(Job* job, TmsTime key);
+
+    /**
+     * @return the job with the smallest key, NULL if the heap is empty
+     */
+    virtual Job* top() const { return heap.empty() ? NULL : heap.front().job; }
+
+    /**
+     * @return the job that would be at the top after #pop, NULL if
+     * there is none, O(1)
+     */
+    Job* second() const;
+
+    /**
+     * @brief Remove the job with the smallest key, O(log n)
+     * @return the removed job, NULL if the heap is empty
+     */
+    virtual Job* pop();
+
+    /**
+     * @brief Remove a job, O(log n)
+     * @param job the job to remove
+     * @return true, if the job was contained in the heap
+     */
+    virtual bool remove(const Job* job);
+
+    /**
+     * @brief Increase the key of a job, O(log n)
+     *
+     * The job is placed in front of the jobs that already have the new
+     * key, like a job that is moved back in a sorted list until it
+     * reaches them.
+     * @param job the job
+     * @param key the new key, must not be smaller than the current one
+     * @return true, if the job was contained in the heap
+     */
+    bool increaseKey(const Job* job, TmsTime key);
+
+    /**
+     * @return true, if the job is contained in this heap, O(1)
+     */
+    virtual bool contains(const Job* job) const;
+
+    virtual size_t size() const { return heap.size(); }
+
+    virtual bool empty() const { return heap.empty(); }
+
+    /**
+     * @brief Append the jobs in the order in which they would be popped,
+     * O(n log n). The keys are not returned, e.g. for
+     * Scheduler::writeState they must be derived from the state of the
+     * jobs.
+     */
+    virtual void getJobs(std::vector<const Job*>& jobs) const;
+
+  private:
+    struct Entry {
+      TmsTime key;
+      int64_t seq; ///< insertion order, breaks ties between equal keys
+      Job* job;
+    };
+
+    static const size_t ARITY = 4;
+
+    static bool before(const Entry& a, const Entry& b) {
+      return a.key < b.key || (a.key == b.key && a.seq < b.seq);
+    }
+
+    void place(size_t i, const Entry& e) {
+      heap[i] = e;
+      e.job->queueHooks[slot].index = i;
+    }
+
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+    void removeAt(size_t i);
+
+    Job::QueueSlot slot;
+    std::vector<Entry> heap;
+    /// sequence number of the next inserted job, counts up
+    int64_t seq;
+    /// sequence number of the next job with an increased key, counts down
+    int64_t frontSeq;
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_JOBHEAP_H */
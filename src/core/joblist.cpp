@@ -0,0 +1,117 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file joblist.cpp
+ * @brief Intrusive list of jobs
+ */
+
+#include <core/joblist.h>
+
+#include <cassert>
+
+namespace tmssim {
+
+  JobList::JobList(Job::QueueSlot _slot)
+    : slot(_slot), head(NULL), tail(NULL), count(0) {
+  }
+
+
+  JobList::iterator JobList::insert(iterator pos, Job* job) {
+    assert(pos.list == this);
+    Job::QueueHook& h = hook(job, slot);
+    assert(h.queue == NULL);
+    Job* next = pos.job;
+    Job* prev = (next == NULL) ? tail : hook(next, slot).prev;
+    h.queue = this;
+    h.prev = prev;
+    h.next = next;
+    if (prev == NULL)
+      head = job;
+    else
+      hook(prev, slot).next = job;
+    if (next == NULL)
+      tail = job;
+    else
+      hook(next, slot).prev = job;
+    ++count;
+    return iterator(this, job);
+  }
+
+
+  JobList::iterator JobList::erase(iterator pos) {
+    assert(pos.list == this && pos.job != NULL);
+    Job::QueueHook& h = hook(pos.job, slot);
+    assert(h.queue == this);
+    Job* next = h.next;
+    if (h.prev == NULL)
+      head = next;
+    else
+      hook(h.prev, slot).next = next;
+    if (next == NULL)
+      tail = h.prev;
+    else
+      hook(next, slot).prev = h.prev;
+    h.queue = NULL;
+    h.prev = NULL;
+    h.next = NULL;
+    --count;
+    return iterator(this, next);
+  }
+
+
+  Job* JobList::pop() {
+    Job* job = head;
+    if (job != NULL)
+      erase(begin());
+    return job;
+  }
+
+
+  bool JobList::remove(const Job* job) {
+    if (!contains(job))
+      return false;
+    erase(iterator(this, const_cast<Job*>(job)));
+    return true;
+  }
+
+
+  void JobList::clear() {
+    Job* job = head;
+    while (job != NULL) {
+      Job::QueueHook& h = hook(job, slot);
+      job = h.next;
+      h.queue = NULL;
+      h.prev = NULL;
+      h.next = NULL;
+    }
+    head = NULL;
+    tail = NULL;
+    count = 0;
+  }
+
+
+  void JobList::getJobs(std::vector<const Job*>& jobs) const {
+    for (const Job* job = head; job != NULL; job = hook(job, slot).next) {
+      jobs.push_back(job);
+    }
+  }
+
+} // NS tmssim
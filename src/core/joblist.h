@@ -0,0 +1,188 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file joblist.h
+ * @brief Intrusive list of jobs
+ */
+
+#ifndef CORE_JOBLIST_H
+#define CORE_JOBLIST_H 1
+
+#include <core/job.h>
+#include <core/jobqueue.h>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Doubly linked list of jobs with the interface of a
+   * std::list<Job*>.
+   *
+   * The jobs are linked through the job objects, using the links of the
+   * list's Job::QueueSlot. Thus, a job knows its position in each list
+   * that contains it: #find, #contains and #remove take O(1) instead of
+   * a search through the list, and inserting and erasing jobs never
+   * allocates. A job can be contained in only one list per slot at a
+   * time. Like with std::list, insertion and removal keep the iterators
+   * to the other jobs valid.
+   *
+   * The list does not own its jobs. A job must not be deleted while it
+   * is contained in a list that is still used.
+   */
+  class JobList : public JobQueue {
+  public:
+    class iterator {
+    public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef Job* value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef Job* const* pointer;
+      typedef Job* const& reference;
+
+      iterator() : list(NULL), job(NULL) {}
+
+      reference operator*() const { return job; }
+
+      iterator& operator++() {
+	job = hook(job, list->slot).next;
+	return *this;
+      }
+
+      iterator operator++(int) {
+	iterator it = *this;
+	++*this;
+	return it;
+      }
+
+      iterator& operator--() {
+	job = (job == NULL) ? list->tail : hook(job, list->slot).prev;
+	return *this;
+      }
+
+      iterator operator--(int) {
+	iterator it = *this;
+	--*this;
+	return it;
+      }
+
+      bool operator==(const iterator& rhs) const { return job == rhs.job; }
+      bool operator!=(const iterator& rhs) const { return job != rhs.job; }
+
+    private:
+      iterator(const JobList* _list, Job* _job) : list(_list), job(_job) {}
+
+      const JobList* list;
+      Job* job; ///< NULL for #end
+      friend class JobList;
+    };
+
+    /// The list cannot change the jobs, so there is only one iterator type
+    typedef iterator const_iterator;
+
+    /**
+     * @param _slot the links of the jobs that are used by this list
+     */
+    explicit JobList(Job::QueueSlot _slot);
+
+    JobList(const JobList&) = delete;
+    JobList& operator=(const JobList&) = delete;
+
+    iterator begin() const { return iterator(this, head); }
+    iterator end() const { return iterator(this, NULL); }
+
+    virtual bool empty() const { return count == 0; }
+    virtual size_t size() const { return count; }
+
+    Job* front() const { return head; }
+    Job* back() const { return tail; }
+
+    /**
+     * @brief Insert a job before pos, O(1)
+     * @param job the job, must not be contained in any list of this
+     * list's slot
+     * @return iterator to the inserted job
+     */
+    iterator insert(iterator pos, Job* job);
+
+    void push_back(Job* job) { insert(end(), job); }
+
+    /**
+     * @brief Erase the job at pos, O(1)
+     * @return iterator to the job following pos
+     */
+    iterator erase(iterator pos);
+
+    void pop_front() { erase(begin()); }
+
+    virtual Job* top() const { return head; }
+
+    /**
+     * @brief Remove the first job, O(1)
+     * @return the removed job, NULL if the list is empty
+     */
+    virtual Job* pop();
+
+    /**
+     * @return true, if the job is contained in this list, O(1)
+     */
+    virtual bool contains(const Job* job) const {
+      return hook(job, slot).queue == this;
+    }
+
+    /**
+     * @return iterator to the job, #end if it is not contained in this
+     * list, O(1)
+     */
+    iterator find(const Job* job) const {
+      return contains(job) ? iterator(this, const_cast<Job*>(job)) : end();
+    }
+
+    /**
+     * @brief Remove a job, O(1)
+     * @return true, if the job was contained in this list
+     */
+    virtual bool remove(const Job* job);
+
+    /**
+     * @brief Remove all jobs, O(n)
+     */
+    void clear();
+
+    virtual void getJobs(std::vector<const Job*>& jobs) const;
+
+  private:
+    /// The links are no state of the job, so they may change for const jobs
+    static Job::QueueHook& hook(const Job* job, Job::QueueSlot slot) {
+      return const_cast<Job*>(job)->queueHooks[slot];
+    }
+
+    Job::QueueSlot slot;
+    Job* head;
+    Job* tail;
+    size_t count;
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_JOBLIST_H */
@@ -0,0 +1,147 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobpool.cpp
+ * @brief Implementation of the job memory pool
+ */
+
+#include <core/jobpool.h>
+
+#include <cassert>
+#include <new>
+
+using namespace std;
+
+namespace tmssim {
+
+  /// Granularity of the size classes
+  static const size_t POOL_ALIGN = 16;
+
+  /// Each block starts with a reference to its pool, padded to POOL_ALIGN
+  static const size_t POOL_HEADER = POOL_ALIGN;
+
+  /// Number of blocks taken from the system at once
+  static const size_t POOL_CHUNK_BLOCKS = 64;
+
+
+  static inline size_t sizeClass(size_t size) {
+    return (size + POOL_ALIGN - 1) / POOL_ALIGN;
+  }
+
+
+  static inline size_t blockSize(size_t sizeClass) {
+    return POOL_HEADER + sizeClass * POOL_ALIGN;
+  }
+
+
+  thread_local JobPool* JobPool::current = NULL;
+
+
+  JobPool::JobPool()
+    : live(0), peakLive(0) {
+  }
+
+
+  JobPool::~JobPool() {
+    // jobs still alive are lost with their chunk; the simulation
+    // deletes its scheduler (and thus all pending jobs) before
+    assert(live == 0);
+    for (void* chunk : chunks) {
+      ::operator delete(chunk);
+    }
+  }
+
+
+  JobPool::Scope::Scope(JobPool* pool)
+    : previous(JobPool::current) {
+    JobPool::current = pool;
+  }
+
+
+  JobPool::Scope::~Scope() {
+    JobPool::current = previous;
+  }
+
+
+  void* JobPool::allocate(size_t size) {
+    JobPool* pool = current;
+    size_t sc = sizeClass(size);
+    char* block;
+    if (pool != NULL) {
+      block = static_cast<char*>(pool->take(sc));
+    }
+    else {
+      block = static_cast<char*>(::operator new(blockSize(sc)));
+    }
+    *reinterpret_cast<JobPool**>(block) = pool;
+    return block + POOL_HEADER;
+  }
+
+
+  void JobPool::release(void* ptr, size_t size) {
+    if (ptr == NULL)
+      return;
+    char* block = static_cast<char*>(ptr) - POOL_HEADER;
+    JobPool* pool = *reinterpret_cast<JobPool**>(block);
+    if (pool != NULL) {
+      pool->give(block, sizeClass(size));
+    }
+    else {
+      ::operator delete(block);
+    }
+  }
+
+
+  void* JobPool::take(size_t sc) {
+    if (sc >= freeLists.size() || freeLists[sc] == NULL) {
+      refill(sc);
+    }
+    void* block = freeLists[sc];
+    freeLists[sc] = *reinterpret_cast<void**>(block);
+    if (++live > peakLive)
+      peakLive = live;
+    return block;
+  }
+
+
+  void JobPool::give(void* block, size_t sc) {
+    assert(sc < freeLists.size());
+    *reinterpret_cast<void**>(block) = freeLists[sc];
+    freeLists[sc] = block;
+    --live;
+  }
+
+
+  void JobPool::refill(size_t sc) {
+    if (sc >= freeLists.size()) {
+      freeLists.resize(sc + 1, NULL);
+    }
+    size_t bs = blockSize(sc);
+    char* chunk = static_cast<char*>(::operator new(POOL_CHUNK_BLOCKS * bs));
+    chunks.push_back(chunk);
+    for (size_t i = POOL_CHUNK_BLOCKS; i > 0; --i) {
+      void* block = chunk + (i - 1) * bs;
+      *reinterpret_cast<void**>(block) = freeLists[sc];
+      freeLists[sc] = block;
+    }
+  }
+
+} // NS tmssim
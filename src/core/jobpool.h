@@ -0,0 +1,113 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobpool.h
+ * @brief Memory pool for jobs
+ */
+
+#ifndef CORE_JOBPOOL_H
+#define CORE_JOBPOOL_H 1
+
+#include <cstddef>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Memory pool from which the jobs of a simulation are allocated.
+   *
+   * Each #tmssim::Simulation owns a pool and passes it to its tasks.
+   * While #tmssim::Task::spawnJob calls the task's spawnHook, the pool
+   * is made the current pool of the executing thread (see #Scope), and
+   * Job::operator new takes the memory from it. Thus, the task models
+   * can still create their jobs (including subclasses of #tmssim::Job)
+   * with <i>new</i> and free them with <i>delete</i>.
+   *
+   * Memory is taken from the system in chunks of several jobs and is
+   * not returned before the pool is destroyed; freed jobs are kept in
+   * free lists per size class. Each block carries a reference to its
+   * pool, so a job can be deleted anywhere. Jobs that are allocated
+   * while no pool is current are taken from the heap.
+   *
+   * A pool is not thread-safe, all its jobs must be created and
+   * deleted by the thread that runs the simulation.
+   */
+  class JobPool {
+  public:
+    JobPool();
+    ~JobPool();
+
+    /**
+     * @brief Makes a pool the current pool of the calling thread
+     * during the lifetime of the Scope object.
+     */
+    class Scope {
+    public:
+      Scope(JobPool* pool);
+      ~Scope();
+    private:
+      JobPool* previous;
+    };
+
+    /**
+     * @brief Allocate memory for a job from the current pool
+     * @param size size of the job object
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Return memory obtained from #allocate
+     * @param ptr the memory
+     * @param size size of the job object
+     */
+    static void release(void* ptr, size_t size);
+
+    /**
+     * @return number of jobs that currently exist
+     */
+    size_t getLiveJobs() const { return live; }
+
+    /**
+     * @return maximum number of jobs that existed at the same time
+     */
+    size_t getPeakLiveJobs() const { return peakLive; }
+
+  private:
+    JobPool(const JobPool&);
+    JobPool& operator=(const JobPool&);
+
+    void* take(size_t sizeClass);
+    void give(void* block, size_t sizeClass);
+    void refill(size_t sizeClass);
+
+    /// Free blocks, linked through their first word, per size class
+    std::vector<void*> freeLists;
+    /// Memory chunks that were taken from the system
+    std::vector<void*> chunks;
+    size_t live;
+    size_t peakLive;
+
+    static thread_local JobPool* current;
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_JOBPOOL_H */
@@ -0,0 +1,163 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobpriorityqueue.cpp
+ * @brief Bucket queue of jobs for static priorities
+ */
+
+#include <core/jobpriorityqueue.h>
+
+#include <cassert>
+
+namespace tmssim {
+
+  JobPriorityQueue::JobPriorityQueue(Job::QueueSlot _slot)
+    : slot(_slot), summary(0), count(0) {
+    for (size_t i = 0; i < WORDS; ++i) {
+      words[i] = 0;
+    }
+  }
+
+
+  void JobPriorityQueue::push(Job* job) {
+    assert(hook(job).queue == NULL);
+    TmsPriority p = job->getPriority();
+    if (p < LEVELS) {
+      if (p >= buckets.size())
+	buckets.resize(p + 1);
+      Bucket& b = buckets[p];
+      if (b.head == NULL) {
+	words[p / WORD_BITS] |= 1ULL << (p % WORD_BITS);
+	summary |= 1ULL << (p / WORD_BITS);
+      }
+      link(b, b.tail, job);
+      hook(job).index = p;
+    }
+    else {
+      Job* pos = overflow.tail;
+      while (pos != NULL && pos->getPriority() > p) {
+	pos = hook(pos).prev;
+      }
+      link(overflow, pos, job);
+      hook(job).index = LEVELS;
+    }
+    ++count;
+  }
+
+
+  Job* JobPriorityQueue::top() const {
+    size_t b = findBucket(0);
+    return b != Job::NO_INDEX ? buckets[b].head : overflow.head;
+  }
+
+
+  Job* JobPriorityQueue::pop() {
+    Job* job = top();
+    if (job != NULL)
+      remove(job);
+    return job;
+  }
+
+
+  bool JobPriorityQueue::remove(const Job* job) {
+    if (!contains(job))
+      return false;
+    size_t p = hook(job).index;
+    Bucket& b = bucket(p);
+    unlink(b, const_cast<Job*>(job));
+    if (p < LEVELS && b.head == NULL) {
+      words[p / WORD_BITS] &= ~(1ULL << (p % WORD_BITS));
+      if (words[p / WORD_BITS] == 0)
+	summary &= ~(1ULL << (p / WORD_BITS));
+    }
+    --count;
+    return true;
+  }
+
+
+  Job* JobPriorityQueue::next(const Job* job) const {
+    assert(contains(job));
+    const Job::QueueHook& h = hook(job);
+    if (h.next != NULL)
+      return h.next;
+    if (h.index == LEVELS)
+      return NULL;
+    size_t b = findBucket(h.index + 1);
+    return b != Job::NO_INDEX ? buckets[b].head : overflow.head;
+  }
+
+
+  void JobPriorityQueue::getJobs(std::vector<const Job*>& jobs) const {
+    for (const Job* job = top(); job != NULL; job = next(job)) {
+      jobs.push_back(job);
+    }
+  }
+
+
+  size_t JobPriorityQueue::findBucket(size_t from) const {
+    size_t w = from / WORD_BITS;
+    if (w >= WORDS)
+      return Job::NO_INDEX;
+    uint64_t bits = words[w] & (~0ULL << (from % WORD_BITS));
+    if (bits == 0) {
+      uint64_t rest = w + 1 < WORDS ? summary & (~0ULL << (w + 1)) : 0;
+      if (rest == 0)
+	return Job::NO_INDEX;
+      w = __builtin_ctzll(rest);
+      bits = words[w];
+    }
+    return w * WORD_BITS + __builtin_ctzll(bits);
+  }
+
+
+  void JobPriorityQueue::link(Bucket& b, Job* pos, Job* job) {
+    Job::QueueHook& h = hook(job);
+    h.queue = this;
+    h.prev = pos;
+    h.next = pos != NULL ? hook(pos).next : b.head;
+    if (h.next != NULL)
+      hook(h.next).prev = job;
+    else
+      b.tail = job;
+    if (pos != NULL)
+      hook(pos).next = job;
+    else
+      b.head = job;
+  }
+
+
+  void JobPriorityQueue::unlink(Bucket& b, Job* job) {
+    Job::QueueHook& h = hook(job);
+    if (h.prev != NULL)
+      hook(h.prev).next = h.next;
+    else
+      b.head = h.next;
+    if (h.next != NULL)
+      hook(h.next).prev = h.prev;
+    else
+      b.tail = h.prev;
+    h.queue = NULL;
+    h.index = Job::NO_INDEX;
+    h.prev = NULL;
+    h.next = NULL;
+  }
+
+} // NS tmssim
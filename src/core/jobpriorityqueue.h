@@ -0,0 +1,149 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobpriorityqueue.h
+ * @brief Bucket queue of jobs for static priorities
+ */
+
+#ifndef CORE_JOBPRIORITYQUEUE_H
+#define CORE_JOBPRIORITYQUEUE_H 1
+
+#include <core/job.h>
+#include <core/jobqueue.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Ready queue of jobs ordered by their static priority.
+   *
+   * Jobs are executed in ascending order of their priority values, jobs
+   * with equal priorities in the order of insertion (FIFO), like in a
+   * sorted list where new jobs are inserted behind all jobs with the same
+   * priority. Each priority below #LEVELS has its own FIFO bucket; a
+   * two-level bitmap records the non-empty buckets, so the first job is
+   * found with two find-first-set operations. Thus, insertion, access to
+   * the first job and removal of an arbitrary job take O(1). The jobs
+   * are linked through the job objects, so a job can only be stored in
+   * one JobQueue per Job::QueueSlot at a time, and its priority must not
+   * change while it is stored.
+   *
+   * Jobs with priorities of #LEVELS or larger (e.g. the optional jobs of
+   * a MkpTask, see TMS_MIN_PRIORITY) share one bucket behind all other
+   * buckets, which is kept sorted by insertion from its end.
+   */
+  class JobPriorityQueue : public JobQueue {
+  public:
+    /// Number of priorities with an own bucket
+    static const size_t LEVELS = 64 * 64;
+
+    /**
+     * @param _slot the links of the jobs that are used by this queue
+     */
+    explicit JobPriorityQueue(Job::QueueSlot _slot);
+
+    /**
+     * @brief Insert a job behind all jobs with the same priority, O(1)
+     * @param job the job, must not be contained in any JobQueue of this
+     * queue's slot
+     */
+    void push(Job* job);
+
+    /**
+     * @return the first job, NULL if the queue is empty
+     */
+    virtual Job* top() const;
+
+    /**
+     * @brief Remove the first job, O(1)
+     * @return the removed job, NULL if the queue is empty
+     */
+    virtual Job* pop();
+
+    /**
+     * @brief Remove a job, O(1)
+     * @param job the job to remove
+     * @return true, if the job was contained in the queue
+     */
+    virtual bool remove(const Job* job);
+
+    /**
+     * @return true, if the job is contained in this queue, O(1)
+     */
+    virtual bool contains(const Job* job) const { return hook(job).queue == this; }
+
+    virtual size_t size() const { return count; }
+
+    virtual bool empty() const { return count == 0; }
+
+    virtual void getJobs(std::vector<const Job*>& jobs) const;
+
+  private:
+    /// FIFO of the jobs with one priority
+    struct Bucket {
+      Bucket() : head(NULL), tail(NULL) {}
+      Job* head;
+      Job* tail;
+    };
+
+    static const size_t WORD_BITS = 64;
+    static const size_t WORDS = LEVELS / WORD_BITS;
+
+    /// @brief The bucket with index b, #LEVELS is the shared one
+    Bucket& bucket(size_t b) { return b < LEVELS ? buckets[b] : overflow; }
+
+    /**
+     * @param job a job of this queue
+     * @return the job behind @p job, NULL if it is the last one
+     */
+    Job* next(const Job* job) const;
+
+    /// @return the first non-empty bucket >= from, NO_INDEX if none
+    size_t findBucket(size_t from) const;
+
+    /// The links are no state of the job, so they may change for const jobs
+    Job::QueueHook& hook(const Job* job) const {
+      return const_cast<Job*>(job)->queueHooks[slot];
+    }
+
+    /// @brief Insert job into b behind pos (at the front if pos is NULL)
+    void link(Bucket& b, Job* pos, Job* job);
+
+    void unlink(Bucket& b, Job* job);
+
+    Job::QueueSlot slot;
+    /// Buckets of the priorities below #LEVELS, grown on demand
+    std::vector<Bucket> buckets;
+    /// Bucket of all larger priorities
+    Bucket overflow;
+    /// Bit i is set if words[i] is not 0
+    uint64_t summary;
+    /// Bit j of words[i] is set if buckets[64 * i + j] is not empty
+    uint64_t words[WORDS];
+    size_t count;
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_JOBPRIORITYQUEUE_H */
@@ -0,0 +1,84 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobqueue.h
+ * @brief Common interface of the job containers of ALDScheduler
+ */
+
+#ifndef CORE_JOBQUEUE_H
+#define CORE_JOBQUEUE_H 1
+
+#include <core/job.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Container from which an ALDScheduler executes its jobs.
+   *
+   * The interface covers the operations that ALDScheduler performs on its
+   * schedule regardless of the order of the jobs. Jobs are inserted through
+   * the concrete container (e.g. JobList::insert or JobHeap::push), which
+   * defines the order. The container does not own its jobs.
+   */
+  class JobQueue {
+  public:
+    virtual ~JobQueue() {}
+
+    /**
+     * @return the first job, NULL if the queue is empty
+     */
+    virtual Job* top() const = 0;
+
+    /**
+     * @brief Remove the first job
+     * @return the removed job, NULL if the queue is empty
+     */
+    virtual Job* pop() = 0;
+
+    /**
+     * @brief Remove a job
+     * @param job the job to remove
+     * @return true, if the job was contained in the queue
+     */
+    virtual bool remove(const Job* job) = 0;
+
+    /**
+     * @return true, if the job is contained in this queue
+     */
+    virtual bool contains(const Job* job) const = 0;
+
+    virtual size_t size() const = 0;
+
+    virtual bool empty() const = 0;
+
+    /**
+     * @brief Append all jobs in the order in which #pop would return
+     * them, e.g. for printing or Scheduler::writeState
+     */
+    virtual void getJobs(std::vector<const Job*>& jobs) const = 0;
+  };
+
+} // NS tmssim
+
+#endif /* !CORE_JOBQUEUE_H */
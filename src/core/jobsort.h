@@ -0,0 +1,81 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file jobsort.h
+ * @brief Stable sort of jobs by a key
+ */
+
+#ifndef CORE_JOBSORT_H
+#define CORE_JOBSORT_H 1
+
+#include <core/job.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief A job with its sorting key, see sortJobs()
+   */
+  template <typename Key>
+  struct KeyedJob {
+    Key key;
+    size_t seq; ///< position in the input, keeps the sort stable
+    Job* job;
+
+    bool operator<(const KeyedJob& rhs) const {
+      return key < rhs.key || (key == rhs.key && seq < rhs.seq);
+    }
+  };
+
+
+  /**
+   * @brief Sort jobs by ascending key, jobs with equal keys stay in the
+   * order of the input.
+   *
+   * std::stable_sort would allocate a temporary buffer. Instead, the
+   * position in the input breaks ties, so the in-place std::sort is
+   * stable. Once @p sorted has grown to the largest input, sorting
+   * takes O(n log n) and never allocates, so schedulers can keep the
+   * vector as a member and sort in every time step.
+   * @param first begin of the jobs
+   * @param last end of the jobs
+   * @param key computes the key of a job
+   * @param[out] sorted the sorted jobs with their keys, previous
+   * contents are discarded
+   */
+  template <typename Key, typename InputIterator>
+  void sortJobs(InputIterator first, InputIterator last,
+		Key (*key)(const Job*), std::vector<KeyedJob<Key> >& sorted) {
+    sorted.clear();
+    for (size_t seq = 0; first != last; ++first, ++seq) {
+      Job* job = *first;
+      KeyedJob<Key> entry = { key(job), seq, job };
+      sorted.push_back(entry);
+    }
+    std::sort(sorted.begin(), sorted.end());
+  }
+
+} // NS tmssim
+
+#endif /* !CORE_JOBSORT_H */
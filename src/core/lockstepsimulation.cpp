@@ -0,0 +1,150 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file lockstepsimulation.cpp
+ * @brief Simulate one task set with several schedulers in lock-step
+ */
+
+#include <core/lockstepsimulation.h>
+#include <core/task.h>
+#include <utils/logger.h>
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+using namespace std;
+
+namespace tmssim {
+
+  LockstepSimulation::LockstepSimulation(const vector<Simulation*>& _simulations)
+    : simulations(_simulations), eventMode(!_simulations.empty()), now(0)
+  {
+    if (simulations.empty())
+      return;
+    now = simulations[0]->getTime();
+    const size_t nTasks = simulations[0]->getTaskset()->size();
+    for (size_t i = 0; i < simulations.size(); ++i) {
+      Simulation* sim = simulations[i];
+      if (sim->isFinalised()) {
+	throw Simulation::SimulationException("LockstepSimulation: simulation is finalised already!");
+      }
+      if (sim->getTime() != now || sim->getTaskset()->size() != nTasks) {
+	throw Simulation::SimulationException("LockstepSimulation: simulations do not match!");
+      }
+      if (sim->getAdvanceMode() != Simulation::AM_EVENT)
+	eventMode = false;
+      active.push_back(i);
+    }
+    activationCalendar.reserve(nTasks);
+    dueTasks.reserve(nTasks);
+    for (size_t i = 0; i < nTasks; ++i) {
+      scheduleActivation(i);
+    }
+  }
+
+
+  vector<Simulation::ExitCondition> LockstepSimulation::run(TmsTimeInterval steps) {
+    vector<Simulation::ExitCondition> ecs(simulations.size(), 0);
+    TmsTime start = now;
+    TmsTime end = start + steps;
+
+    LOG(LOG_CLASS_SIMULATION) << "Lock-step simulation of " << simulations.size()
+			      << " schedulers from " << start << " until " << end;
+
+    for ( ; now < end && !active.empty(); ++now) {
+      dueTasks.clear();
+      while (!activationCalendar.empty() && activationCalendar.front().first <= now) {
+	dueTasks.push_back(activationCalendar.front().second);
+	pop_heap(activationCalendar.begin(), activationCalendar.end(), greater<CalendarEntry>());
+	activationCalendar.pop_back();
+      }
+      sort(dueTasks.begin(), dueTasks.end());
+
+      for (size_t pos = 0; pos < active.size(); ) {
+	Simulation::ExitCondition ec = simulations[active[pos]]->lockstepStep(dueTasks);
+	if (ec != 0)
+	  stop(pos, ec, ecs);
+	else
+	  ++pos;
+      }
+      if (active.empty())
+	break;
+
+      for (size_t i : dueTasks) {
+	scheduleActivation(i);
+      }
+
+      if (eventMode) {
+	TmsTime next = end;
+	if (!activationCalendar.empty() && activationCalendar.front().first < next)
+	  next = activationCalendar.front().first;
+	for (size_t i : active) {
+	  TmsTime t = simulations[i]->getNextSchedulerEventTime();
+	  if (t < next)
+	    next = t;
+	}
+	if (next > now + 1) {
+	  for (size_t pos = 0; pos < active.size(); ) {
+	    Simulation::ExitCondition ec = simulations[active[pos]]->lockstepAdvance(next - now - 1);
+	    if (ec != 0)
+	      stop(pos, ec, ecs);
+	    else
+	      ++pos;
+	  }
+	  now = next - 1;
+	}
+      }
+    }
+    LOG(LOG_CLASS_SIMULATION) << "Lock-step simulation ended at " << now;
+
+    for (size_t i = 0; i < simulations.size(); ++i) {
+      simulations[i]->endLockstep(ecs[i]);
+    }
+    return ecs;
+  }
+
+
+  void LockstepSimulation::scheduleActivation(size_t taskNum) {
+    TmsTime next = (*simulations[active[0]]->getTaskset())[taskNum]->getNextActivation();
+    for (size_t pos = 1; pos < active.size(); ++pos) {
+      if ((*simulations[active[pos]]->getTaskset())[taskNum]->getNextActivation() != next) {
+	ostringstream oss;
+	oss << "LockstepSimulation: activations of task " << taskNum
+	    << " differ between simulations " << active[0] << " and " << active[pos];
+	throw Simulation::SimulationException(oss.str());
+      }
+    }
+    activationCalendar.push_back(CalendarEntry(next, taskNum));
+    push_heap(activationCalendar.begin(), activationCalendar.end(), greater<CalendarEntry>());
+  }
+
+
+  void LockstepSimulation::stop(size_t pos, Simulation::ExitCondition ec,
+				vector<Simulation::ExitCondition>& ecs) {
+    LOG(LOG_CLASS_SIMULATION) << "Lock-step simulation " << active[pos]
+			      << " failed at " << simulations[active[pos]]->getTime()
+			      << " (ec: " << ec << ")";
+    ecs[active[pos]] = ec;
+    active.erase(active.begin() + pos);
+  }
+
+} // NS tmssim
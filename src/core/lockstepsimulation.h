@@ -0,0 +1,107 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file lockstepsimulation.h
+ * @brief Simulate one task set with several schedulers in lock-step
+ */
+
+#ifndef CORE_LOCKSTEPSIMULATION_H
+#define CORE_LOCKSTEPSIMULATION_H 1
+
+#include <core/simulation.h>
+
+#include <utility>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Advances several simulations of the same task set in lock-step
+   *
+   * Comparative evaluations simulate one task set with many schedulers.
+   * Instead of running the simulations one after another, each with its
+   * own activation calendar, a LockstepSimulation keeps a single
+   * calendar for all of them and feeds the same activations to every
+   * simulation in each time step. The per-scheduler state (scheduler,
+   * job queues, task monitors) still lives in the individual
+   * simulations.
+   *
+   * All simulations must contain the same tasks (in the same order) with
+   * the same activation pattern, i.e. strictly periodic tasks. If the
+   * next activations of a task differ between the simulations, a
+   * Simulation::SimulationException is thrown.
+   *
+   * The results of each simulation are the same as if it had been run
+   * on its own. In AM_EVENT mode, time steps are skipped only if no
+   * simulation has an event in them, so the EXEC traces of the
+   * simulations may contain more advance entries, and they are
+   * interleaved.
+   */
+  class LockstepSimulation {
+  public:
+    /**
+     * @param _simulations the simulations, must not be finalised and be
+     * at the same time step. The objects are not owned by the
+     * LockstepSimulation.
+     */
+    LockstepSimulation(const std::vector<Simulation*>& _simulations);
+
+    /**
+     * @brief Run all simulations for the given number of steps
+     *
+     * A simulation that fails is stopped in the failing time step, the
+     * others go on. Afterwards, the simulations can be finalised and
+     * evaluated like after Simulation::run.
+     * @return the exit condition of each simulation
+     */
+    std::vector<Simulation::ExitCondition> run(TmsTimeInterval steps);
+
+    TmsTime getTime() const { return now; }
+
+  private:
+    typedef std::pair<TmsTime, size_t> CalendarEntry;
+
+    /**
+     * @brief Insert a task into the #activationCalendar at its next
+     * activation time, which must be the same in all #active simulations
+     * @param taskNum index of the task in the task sets
+     */
+    void scheduleActivation(size_t taskNum);
+
+    /// @brief Remove a failed simulation from #active
+    void stop(size_t pos, Simulation::ExitCondition ec,
+	      std::vector<Simulation::ExitCondition>& ecs);
+
+    std::vector<Simulation*> simulations;
+    /// indices of the simulations that have not failed yet
+    std::vector<size_t> active;
+    /// min-heap of the next activation of each task
+    std::vector<CalendarEntry> activationCalendar;
+    /// tasks activated in the current step, reused in each step
+    std::vector<size_t> dueTasks;
+    /// skip idle time steps, only if all simulations are in AM_EVENT mode
+    bool eventMode;
+    TmsTime now;
+  };
+
+} // NS tmssim
+
+#endif // !CORE_LOCKSTEPSIMULATION_H
@@ -32,6 +32,7 @@ namespace tmssim {
    * Time counter
    */
   typedef int64_t TmsTime;
+  #define TMS_TIME_MAX ((TmsTime) INT64_MAX)
 
   /**
    * Description of time intervals, e.g. periods, execution times
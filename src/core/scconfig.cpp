@@ -34,12 +34,15 @@ namespace tmssim {
 
   const bool SchedulerConfiguration::defaultExecCancellations = true;
   const bool SchedulerConfiguration::defaultDlMissCancellations = true;
+  const bool SchedulerConfiguration::defaultHeapReadyQueue = false;
 
   
   SchedulerConfiguration::SchedulerConfiguration(bool _execCancellations,
-						 bool _dlMissCancellations)
+						 bool _dlMissCancellations,
+						 bool _heapReadyQueue)
     : execCancellations(_execCancellations),
-      dlMissCancellations(_dlMissCancellations) {
+      dlMissCancellations(_dlMissCancellations),
+      heapReadyQueue(_heapReadyQueue) {
   }
 
   
@@ -57,6 +60,13 @@ namespace tmssim {
     else {
       dlMissCancellations = SchedulerConfiguration::defaultDlMissCancellations;
     }
+
+    if (conf.containsKey("heapReadyQueue")) {
+      heapReadyQueue = conf.getBool("heapReadyQueue");
+    }
+    else {
+      heapReadyQueue = SchedulerConfiguration::defaultHeapReadyQueue;
+    }
   }
 
 
@@ -74,6 +84,13 @@ namespace tmssim {
     else {
       dlMissCancellations = SchedulerConfiguration::defaultDlMissCancellations;
     }
+
+    if (conf->containsKey("heapReadyQueue")) {
+      heapReadyQueue = conf->getBool("heapReadyQueue");
+    }
+    else {
+      heapReadyQueue = SchedulerConfiguration::defaultHeapReadyQueue;
+    }
   }
 
   
@@ -35,13 +35,16 @@ namespace tmssim {
 
     static const bool defaultExecCancellations;
     static const bool defaultDlMissCancellations;
+    static const bool defaultHeapReadyQueue;
     
-    SchedulerConfiguration(bool _execCancellations=defaultExecCancellations, bool _dlMissCancellations=defaultDlMissCancellations);
+    SchedulerConfiguration(bool _execCancellations=defaultExecCancellations, bool _dlMissCancellations=defaultDlMissCancellations, bool _heapReadyQueue=defaultHeapReadyQueue);
     SchedulerConfiguration(const KvFile& conf);
     SchedulerConfiguration(const KvFile* conf);
 
     bool execCancellations;
     bool dlMissCancellations;
+    /// keep ready jobs in a JobHeap instead of a list (where supported)
+    bool heapReadyQueue;
   };
 
   extern SchedulerConfiguration DefaultSchedulerConfiguration;
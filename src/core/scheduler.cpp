@@ -29,8 +29,39 @@
  */
 
 #include <core/scheduler.h>
+#include <core/steadystate.h>
 
 namespace tmssim {
 
+  TmsTime Scheduler::getNextEventTime(TmsTime now) const {
+    return now + 1;
+  }
+
+
+  void Scheduler::enqueueJobs(const std::vector<Job*>& jobs) {
+    for (Job* job: jobs) {
+      enqueueJob(job);
+    }
+  }
+
+
+  int Scheduler::advance(TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat) {
+    for (TmsTimeInterval i = 0; i < steps; ++i) {
+      DispatchStat stepStat;
+      Job* job = dispatch(now + i, stepStat);
+      if (job != NULL) {
+	// finishing or failing a job is an event, we must not get here
+	return ESC_DISP_COMP;
+      }
+      dispatchStat.executed = stepStat.executed;
+      dispatchStat.idle = stepStat.idle;
+    }
+    return 0;
+  }
+
+
+  bool Scheduler::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
 
 } // NS tmssim
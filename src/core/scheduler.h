@@ -36,19 +36,23 @@
 
 namespace tmssim {
 
+  class StateSnapshot;
+
   /// Use this macro to check Job* return values
 #define SC_ERR(e) ((Job *)(e))
   
 
   /**
    * Scheduling statistics.
+   * The simulation reuses one object for all calls, so the vector keeps
+   * its memory.
    * @todo make list contain const Job*
    */
   struct ScheduleStat {
     ScheduleStat();
     ~ScheduleStat();
     
-    std::list<Job*> cancelled;
+    std::vector<Job*> cancelled;
   };
   
   
@@ -105,6 +109,17 @@ namespace tmssim {
      */
     virtual void enqueueJob(Job *job) = 0;
 
+    /**
+     * @brief Enqueue all jobs that were activated in the same time step
+     *
+     * The jobs are given in the order in which #enqueueJob would be
+     * called for them, and the result must be the same. The default
+     * implementation does exactly this; schedulers that keep a sorted
+     * ready list may sort the batch once and merge it into the list.
+     * @param jobs the new jobs
+     */
+    virtual void enqueueJobs(const std::vector<Job*>& jobs);
+
     /**
      * @brief Remove an active job that was previously enqueued
      * @return A pointer to the removed job, or NULL if no job was found
@@ -149,6 +164,38 @@ namespace tmssim {
      * @return finished job, NULL (running/idling), or ESC_DISP error code
      */
     virtual Job* dispatch(TmsTime now, DispatchStat& dispatchStat) = 0;
+
+    /**
+     * @brief Find the next point in time at which the scheduler must be
+     * stepped regularly.
+     *
+     * This method is used by the event-driven time advance of
+     * #tmssim::Simulation and is called after the time step @p now was
+     * simulated completely. Up to (excluding) the returned time,
+     * #initStep and #schedule must not change the schedule, and
+     * #dispatch must not finish a job, as long as no new jobs are
+     * enqueued. The simulation may then replace these time steps
+     * by a single call to #advance.
+     * The default implementation returns now + 1, i.e. no time steps
+     * can be skipped.
+     * @param now the last simulated time step
+     * @return time of the next scheduling event, must be > now
+     */
+    virtual TmsTime getNextEventTime(TmsTime now) const;
+
+    /**
+     * @brief Execute the current schedule for several time steps at once.
+     *
+     * This method is only called for intervals that end before the time
+     * returned by #getNextEventTime. The default implementation calls
+     * #dispatch for each single time step.
+     * @param now first time step of the interval
+     * @param steps length of the interval
+     * @param[out] dispatchStat Container for statistics. idle is set
+     * if no job was executed in the interval.
+     * @return 0 on success, ESC_DISP error code else
+     */
+    virtual int advance(TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat);
     
     /**
      * @brief Check if there are enqueued jobs
@@ -166,6 +213,20 @@ namespace tmssim {
      */
     virtual void printSchedule() const {}
 
+    /**
+     * @brief Write the complete state of the scheduler for steady-state
+     * detection, see Simulation::setSteadyStateDetection.
+     *
+     * The state comprises all jobs the scheduler holds, in the order in
+     * which they will be considered, and any further data that
+     * influences future scheduling decisions. The default
+     * implementation returns false, which disables steady-state
+     * detection. Subclasses that keep state beyond the one written by
+     * their base class must override this method.
+     * @return true if the state was written
+     */
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
   protected:
     /**
      * @brief Logging/tracing of execution
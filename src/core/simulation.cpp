@@ -29,10 +29,14 @@
  */
 
 #include <core/simulation.h>
+#include <core/basicsimulation.h>
 //#include <core/stat.h>
 #include <utils/tlogger.h>
+#include <utils/tmsmath.h>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <vector>
 #include <sstream>
@@ -57,6 +61,7 @@ namespace tmssim {
       esum(0),
       cancelSteps(0),
       idleSteps(0),
+      peakJobs(0),
       taskset(ts),
       schedulerId("")
   {
@@ -77,6 +82,7 @@ namespace tmssim {
       esum(rhs.esum),
       cancelSteps(rhs.cancelSteps),
       idleSteps(rhs.idleSteps),
+      peakJobs(rhs.peakJobs),
       taskset(rhs.taskset),
       schedulerId(rhs.schedulerId)
   {
@@ -96,6 +102,7 @@ namespace tmssim {
     esum = rhs.esum;
     cancelSteps = rhs.cancelSteps;
     idleSteps = rhs.idleSteps;
+    peakJobs = rhs.peakJobs;
     taskset = rhs.taskset;
     schedulerId = rhs.schedulerId;
     return *this;
@@ -119,10 +126,36 @@ namespace tmssim {
   }
 
 
+  Simulation::AdvanceMode Simulation::defaultAdvanceMode = Simulation::AM_TICK;
+
+
+  void Simulation::setDefaultAdvanceMode(AdvanceMode mode) {
+    defaultAdvanceMode = mode;
+  }
+
+
+  bool Simulation::defaultSteadyStateDetection = false;
+
+
+  void Simulation::setDefaultSteadyStateDetection(bool enable) {
+    defaultSteadyStateDetection = enable;
+  }
+
+
+  TmsTime Simulation::allocationWarmup = 1000;
+
+
+  void Simulation::setAllocationWarmup(TmsTime steps) {
+    allocationWarmup = steps;
+  }
+
+
   Simulation::Simulation(Taskset* _taskset, Scheduler* _scheduler, ExitCondition _exitCondition) :
     taskset(_taskset), scheduler(_scheduler), exitCondition(_exitCondition), //steps(_steps),
-    stats(_taskset), now(0), finalised(false)
-    
+    allocatingSteps(0), stats(_taskset), now(0), finalised(false),
+    advanceMode(defaultAdvanceMode),
+    steadyStateDetection(defaultSteadyStateDetection), hyperperiod(0),
+    nextStateCheck(TMS_TIME_MAX), lambda(0), power(1), timeOffset(0)
   {
     cancelSteps = 0;
     idleSteps = 0;
@@ -134,8 +167,29 @@ namespace tmssim {
 
     initCounters();
 
+    taskStats.resize(taskset->size());
+    // usually, a time step cancels at most one job per task
+    scheduleStat.cancelled.reserve(taskset->size());
     for (size_t taskNum = 0; taskNum< (*taskset).size(); taskNum++) {
+      (*taskset)[taskNum]->setJobPool(&jobPool);
+      (*taskset)[taskNum]->setStatsSlot(&taskStats, taskNum);
       (*taskset)[taskNum]->start(0);
+      scheduleActivation(taskNum);
+    }
+
+    hyperperiod = taskset->empty() ? 0 : 1;
+    for (Task* t : *taskset) {
+      TmsTimeInterval period = t->getActivationPeriod();
+      if (period <= 0) {
+	hyperperiod = 0;
+	break;
+      }
+      TmsTime factor = hyperperiod / calculateGcd(hyperperiod, period);
+      if (factor > TMS_TIME_MAX / period) {
+	hyperperiod = 0;
+	break;
+      }
+      hyperperiod = factor * period;
     }
     now = 0;
   }
@@ -152,86 +206,33 @@ namespace tmssim {
 
   
   Simulation::ExitCondition Simulation::run(TmsTimeInterval steps) {
-    if (finalised) {
-      throw SimulationException("Cannot run simulation as it is finalised already!");
-    }
-
-    /*
-    LOG(LOG_CLASS_SIMULATION) << "######## Continuing simulation with scheduler " << scheduler->getId();
-    LOG(LOG_CLASS_SIMULATION) << "\tAim are " << steps << " iterations";
-    */
+    return runSteps<Scheduler, Task>(steps);
+  }
 
-    Simulation::ExitCondition ec = 0;
-    TmsTime start = now;
-    TmsTime end = start + steps;
 
-    LOG(LOG_CLASS_SIMULATION) << "Simulate from " << start << " for " << steps << " steps until " << end;
-      
-    for ( ; now < end; ++now) {
-      LOG(LOG_CLASS_SIMULATION) << "T : " << now;
+  Simulation::ExitCondition Simulation::finalise() {
+    return finaliseSteps<Scheduler, Task>();
+  }
 
-      ec = initStep();
-      if (ec != 0) {
-	LOG(LOG_CLASS_SIMULATION) << "InitStep failed in regular time step " << now << " (ec: " << ec << ")";
-	break;
-      }
 
-      doActivations();
+  Simulation::ExitCondition Simulation::lockstepStep(const vector<size_t>& dueTasks) {
+    return stepWith<Scheduler, Task>(dueTasks);
+  }
 
-      ec = doExecutions();
-      if (ec != 0) {
-	LOG(LOG_CLASS_SIMULATION) << "Executions failed in regular time step " << now << " (ec: " << ec << ")";
-	break;
-      }
-    }
-    LOG(LOG_CLASS_SIMULATION) << "Totally simulated time: " << (now - start);
-    
-    
-    // Save the statistics in a other object
-    //storeStatistics(statistics);
 
-    /*
-    calculateStatistics();
-    stats.simulatedTime = now;
-    */
-    // store this one if intermediate results are requested
-    stats.success = ec == 0;
-    return ec;
+  Simulation::ExitCondition Simulation::lockstepAdvance(TmsTimeInterval steps) {
+    return advanceBy<Scheduler>(steps);
   }
 
 
-  Simulation::ExitCondition Simulation::finalise() {
-    if (finalised) {
-      throw SimulationException("Simulation is already finalised!");
-    }
-    
-    Simulation::ExitCondition ec = 0;
-    while (scheduler->hasPendingJobs()) {
-      ec = initStep();
-      if (ec != 0) {
-	LOG(LOG_CLASS_SIMULATION) << "Executions failed in regular time step " << now;
-	break;
-      }
-      ec = doExecutions();
-      ++now;
-      if (ec != 0) {
-	LOG(LOG_CLASS_SIMULATION) << "Executions failed in during cleanup in step " << now;
-	break;
-      }
-    }
-    
-    printExecStats(scheduler->getId());
-    printDelayCounters();
-
-    finalised = true;
-    
-    return ec;
+  TmsTime Simulation::getNextSchedulerEventTime() const {
+    return nextSchedulerEvent<Scheduler>();
   }
 
 
   const SimulationResults Simulation::getResults() {
     calculateStatistics();
-    stats.simulatedTime = now;
+    stats.simulatedTime = now + timeOffset;
     return stats;
   }
 
@@ -247,201 +248,112 @@ namespace tmssim {
       }*/
     cancelSteps = 0;
     idleSteps = 0;
-    cancelStepList.clear();
   }
 
 
-  Simulation::ExitCondition Simulation::initStep() {
-    ScheduleStat scStat;
-    //LOG(LOG_CLASS_SIMULATION) << "initStep";
-    Simulation::ExitCondition myRv = 0;
-    int scrv = scheduler->initStep(now, scStat);
-    if (scrv != 0 && ((exitCondition & Simulation::EC_INIT_STEP) != 0)) {
-      myRv = Simulation::EC_INIT_STEP;
-    }
-    if (myRv == 0 && scStat.cancelled.size() > 0) {
-      bool rv = true;
-      LOG(LOG_CLASS_SIMULATION) << "Have initStep cancellations!";
-      rv = performCancellations(scStat);
-      if (!rv && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
-	myRv = Simulation::EC_CANCEL;
-      }
+  void Simulation::reportAllocations(unsigned long n) {
+    // log output allocates anyway
+    if (LOG_ACTIVE(LOG_CLASS_EXEC) || LOG_ACTIVE(LOG_CLASS_SIMULATION))
+      return;
+    if (allocatingSteps < 10) {
+      tError() << "Simulation with " << scheduler->getId() << ": " << n
+	       << " heap allocation(s) in time step " << now;
     }
-    //LOG(LOG_CLASS_SIMULATION) << "/initStep";
-    return myRv;
+    ++allocatingSteps;
   }
 
-  
-  void Simulation::doActivations() {
-    tDebug() << "\nActivations [" << now << "]";
-    //bool rv = false;
-    list<Job*> actList;
-    for (size_t i = 0; i < taskset->size(); i++) {
-      Job* job = NULL;
-      job = (*taskset)[i]->spawnJob(now);
-      if (job != NULL) {
-	scheduler->enqueueJob(job);
-	actList.push_back(job);
-	//rv = true;
-      }
-    }
-    if (actList.size() > 0) {
-      ostringstream oss;
-      oss << "A@" << now << " :";
-      ostringstream osb;
-      osb << "\t";
-      //log << "A@" << now << " :";
-      for (list<Job*>::iterator it = actList.begin(); it != actList.end(); ++it) {
-	oss << " {" << *(*it) << "}";
-	osb << *it << " ";
-      }
-      LOG(LOG_CLASS_EXEC) << oss.str();
-      tDebug() << osb.str();
-    }
-    //return rv;
+
+  TmsTime Simulation::startSteadyStateDetection() {
+    if (!steadyStateDetection || hyperperiod == 0
+	|| LOG_ACTIVE(LOG_CLASS_EXEC) || LOG_ACTIVE(LOG_CLASS_SIMULATION)
+	|| LOG_ACTIVE(LOG_CLASS_TASK) || LOG_ACTIVE(LOG_CLASS_SCHEDULER)
+	|| TLOG_ACTIVE(TLL_DEBUG))
+      return TMS_TIME_MAX;
+    lambda = 0;
+    power = 1;
+    // first hyperperiod boundary at or after now
+    return (now + hyperperiod - 1) / hyperperiod * hyperperiod;
   }
 
-  
-  Simulation::ExitCondition Simulation::doExecutions() {
-    tDebug() << "Executions [" << now << "]";
-
-    // Schedule
-    ScheduleStat scStat;
-    int scrv = scheduler->schedule(now, scStat);
-    if (scrv != 0) {
-      LOG(LOG_CLASS_SIMULATION) << "Schedule failed: " << scrv;
-      //return false;
-      if ((exitCondition & Simulation::EC_SCHEDULE) != 0)
-	return Simulation::EC_SCHEDULE;
-    }
 
-    
-    if (scStat.cancelled.size() > 0) {
-      bool rv = true;
-      LOG(LOG_CLASS_SIMULATION) << "Have schedule cancellations!";
-      rv = performCancellations(scStat);
-      /*
-      bool rv = true;
-      int ctr = 0;
-      ostringstream oss;
-      oss << "C@" << now << " :";
-      for (list<Job*>::iterator it = scStat.cancelled.begin(); it != scStat.cancelled.end(); ++it) {
-	Job* cjob = *it;
-	//cout << "\tcanceling job " << cjob << " " << *cjob;
-	oss << " {" << *cjob << "}";
-	Task *task = cjob->getTask();
-	rv &= task->cancelJob(cjob);
-	ctr++;
-      }
-      LOG(LOG_CLASS_EXEC) << oss.str();
-      //assert(ctr <= CANCEL_SLOTS);
-      //++cancelCtr[ctr - 1];
-      ++cancelSteps;
-      //statPtr->addToCancelStepList(now);
-      cancelStepList.push_back(now);
-      */
-      if (!rv && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
-	return Simulation::EC_CANCEL;
-      }
-    }
-    
-    // Dispatch
-    Job* job = NULL;
-    DispatchStat dispStat;
-    job = scheduler->dispatch(now, dispStat);
-    ostringstream oss;
-    oss << "E@" << now << " : ";
-    if (dispStat.idle) {
-      oss << "I";
-      ++idleSteps;
-    }
-    else {
-      if (dispStat.executed != NULL)
-	oss << "{" << *dispStat.executed << "} ";
-      else
-	oss << "EXEC FAIL";
+  TmsTime Simulation::checkSteadyState(TmsTime& end) {
+    if (!writeState(current)) {
+      tDebug() << "Simulation with " << scheduler->getId()
+	       << ": steady-state detection not supported";
+      return TMS_TIME_MAX;
     }
-    
-    if ((long int) job < 0) {
-      oss << "\tDispatching failed: " << (long int) job;
-      if ((exitCondition & Simulation::EC_DISPATCH) != 0)
-	return Simulation::EC_DISPATCH;
-    }
-    else if (job != NULL) { // equiv to dispStat->finished != NULL
-      assert(job == dispStat.finished);
-      // TODO: Task-Specific notification symbols
-      // TODO: match with \(([A-Z])(,[A-Z])*\)
-      oss << "(F";
-      if (dispStat.dlMiss) {
-	oss << ",M";
+    StateSnapshot::Recorder recorder(current);
+    visitCounters(recorder);
+
+    if (lambda > 0 && current.sameState(tortoise)) {
+      TmsTimeInterval cycle = lambda * hyperperiod;
+      int64_t n = (end - now) / cycle;
+      if (n > 0 && current.canExtrapolate(tortoise, n)) {
+	StateSnapshot::Extrapolator extrapolator(tortoise, current, n);
+	visitCounters(extrapolator);
+	timeOffset += n * cycle;
+	end -= n * cycle;
+	tDebug() << "Simulation with " << scheduler->getId()
+		 << ": state at " << now << " repeats every " << cycle
+		 << " steps, skipped " << n << " cycles";
       }
-      oss << ") ";
-      LOG(LOG_CLASS_EXEC) << oss.str();
-      Task *task = job->getTask();
-      task->completeJob(job, now);
-      return 0;
+      // the remaining steps are less than one cycle
+      return TMS_TIME_MAX;
     }
-    else {
-      LOG(LOG_CLASS_EXEC) << oss.str();
-      return 0;
+
+    if (lambda == 0 || lambda == power) {
+      // move the tortoise to the current state
+      tortoise.swap(current);
+      if (lambda > 0)
+	power *= 2;
+      lambda = 0;
     }
-    return 0;
+    ++lambda;
+    return now + hyperperiod;
   }
 
 
-  bool Simulation::performCancellations(const ScheduleStat& scStat) {
-    bool rv = true;
-    int ctr = 0;
-    ostringstream oss;
-    oss << "C@" << now << " :";
-    for (list<Job*>::const_iterator it = scStat.cancelled.begin(); it != scStat.cancelled.end(); ++it) {
-      Job* cjob = *it;
-      //cout << "\tcanceling job " << cjob << " " << *cjob;
-      oss << " {" << *cjob << "}";
-      Task *task = cjob->getTask();
-      rv &= task->cancelJob(cjob);
-      ctr++;
+  bool Simulation::writeState(StateSnapshot& snapshot) const {
+    snapshot.begin(now);
+    if (!scheduler->writeState(snapshot))
+      return false;
+    for (const Task* task : *taskset) {
+      if (!task->writeState(snapshot))
+	return false;
     }
-    LOG(LOG_CLASS_EXEC) << oss.str();
-    //assert(ctr <= CANCEL_SLOTS);
-    //++cancelCtr[ctr - 1];
-    ++cancelSteps;
-    //statPtr->addToCancelStepList(now);
-    cancelStepList.push_back(now);
-    return rv;
-    /*if (!rv) { // && ((exitCondition & Simulation::EC_CANCEL) != 0)) {
-      return Simulation::EC_CANCEL;
+    return true;
+  }
+
+
+  void Simulation::visitCounters(CounterVisitor& visitor) {
+    visitor.visit(cancelSteps);
+    visitor.visit(idleSteps);
+    taskStats.visitCounters(visitor);
+    for (Task* task : *taskset) {
+      task->visitCounters(visitor);
     }
-    else {
-      return 0;
-      }*/
   }
-  
 
+
+  void Simulation::scheduleActivation(size_t taskNum) {
+    activationCalendar.push_back(CalendarEntry((*taskset)[taskNum]->getNextActivation(), taskNum));
+    push_heap(activationCalendar.begin(), activationCalendar.end(), greater<CalendarEntry>());
+  }
+
+  
   void Simulation::calculateStatistics() {
-    stats.activations = 0;
-    stats.completions = 0;
-    stats.cancellations = 0;
-    stats.execCancellations = 0;
-    stats.ecPerformanceLost = 0;
-    stats.misses = 0;
-    stats.preemptions = 0;
-    stats.usum = 0;
-    stats.esum = 0;
-    for (size_t i = 0; i < taskset->size(); i++) {
-      Task* task = (*taskset)[i];
-      stats.activations += task->getActivations();
-      stats.completions += task->getCompletions();
-      stats.cancellations += task->getCancellations();
-      stats.execCancellations += task->getExecCancellations();
-      stats.ecPerformanceLost += task->getEcPerformanceLost();
-      stats.misses += task->getMisses();
-      stats.preemptions += task->getPreemptions();
-      stats.usum += task->getUA()->getTotal();
-      stats.esum += task->getUA()->getCount();
-    }
+    stats.activations = TaskStatsTable::sum(taskStats.activations);
+    stats.completions = TaskStatsTable::sum(taskStats.completions);
+    stats.cancellations = TaskStatsTable::sum(taskStats.cancellations);
+    stats.execCancellations = TaskStatsTable::sum(taskStats.execCancellations);
+    stats.ecPerformanceLost = TaskStatsTable::sum(taskStats.ecPerformanceLost);
+    stats.misses = TaskStatsTable::sum(taskStats.misses);
+    stats.preemptions = TaskStatsTable::sum(taskStats.preemptions);
+    stats.usum = TaskStatsTable::sum(taskStats.usum);
+    stats.esum = TaskStatsTable::sum(taskStats.esum);
     stats.cancelSteps = cancelSteps;
     stats.idleSteps = idleSteps;
+    stats.peakJobs = jobPool.getPeakLiveJobs();
   }
   
   /*
@@ -479,41 +391,33 @@ namespace tmssim {
   */
   
   void Simulation::printExecStats(const string& head) {
-    int activations = 0, completions = 0, cancellations = 0, execCancellations = 0, misses = 0, preemptions = 0;
-    TmsTime ecPerformanceLost = 0;
-    double usum = 0;
-    int esum = 0;
+    if (!LOG_ACTIVE(LOG_CLASS_SIMULATION))
+      return;
+    const TaskStatsTable& ts = taskStats;
     LOG(LOG_CLASS_SIMULATION) << head;
     LOG(LOG_CLASS_SIMULATION) << "# Task [hv] {act|compl|canc/ecanc|miss|preempt} [UA]";
     for (size_t i = 0; i < taskset->size(); i++) {
       Task* task = (*taskset)[i];
       LOG(LOG_CLASS_SIMULATION) << task->getIdString()
-				<< " {" << task->getActivations()
-				<< "|" << task->getCompletions()
-				<< "|" << task->getCancellations()
-				<< "/" << task->getExecCancellations()
-				<< "(" << task->getEcPerformanceLost() << ")"
-				<< "|" << task->getMisses()
-				<< "|" << task->getPreemptions()
+				<< " {" << ts.activations[i]
+				<< "|" << ts.completions[i]
+				<< "|" << ts.cancellations[i]
+				<< "/" << ts.execCancellations[i]
+				<< "(" << ts.ecPerformanceLost[i] << ")"
+				<< "|" << ts.misses[i]
+				<< "|" << ts.preemptions[i]
 				<< "} " << *(task->getUA())
 	;
-      activations += task->getActivations();
-      completions += task->getCompletions();
-      cancellations += task->getCancellations();
-      execCancellations += task->getExecCancellations();
-      ecPerformanceLost += task->getEcPerformanceLost();
-      misses += task->getMisses();
-      preemptions += task->getPreemptions();
-      usum += task->getUA()->getTotal();
-      esum += task->getUA()->getCount();
     }
-    LOG(LOG_CLASS_SIMULATION) << "Act: " << activations
-			      << " Compl: " << completions
-			      << " Canc: " << cancellations
-			      << " Ecanc: " << execCancellations
-			      << "(" << ecPerformanceLost << ")"
-			      << " Miss: " << misses
-			      << " Preempt: " << preemptions;
+    double usum = TaskStatsTable::sum(ts.usum);
+    int esum = TaskStatsTable::sum(ts.esum);
+    LOG(LOG_CLASS_SIMULATION) << "Act: " << TaskStatsTable::sum(ts.activations)
+			      << " Compl: " << TaskStatsTable::sum(ts.completions)
+			      << " Canc: " << TaskStatsTable::sum(ts.cancellations)
+			      << " Ecanc: " << TaskStatsTable::sum(ts.execCancellations)
+			      << "(" << TaskStatsTable::sum(ts.ecPerformanceLost) << ")"
+			      << " Miss: " << TaskStatsTable::sum(ts.misses)
+			      << " Preempt: " << TaskStatsTable::sum(ts.preemptions);
     LOG(LOG_CLASS_SIMULATION) << "U_Sys/ [" << usum << "/" << esum << "="
 			      << (usum / esum) << "]";
     
@@ -537,6 +441,7 @@ namespace tmssim {
     LOG(LOG_CLASS_SIMULATION) << osscc.str();
     */
     LOG(LOG_CLASS_SIMULATION) << "Idle steps: " << idleSteps;
+    LOG(LOG_CLASS_SIMULATION) << "Peak live jobs: " << jobPool.getPeakLiveJobs();
   }
 
   
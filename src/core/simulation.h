@@ -32,9 +32,14 @@
 
 #include <core/primitives.h>
 #include <core/task.h>
+#include <core/jobpool.h>
+#include <core/taskstatstable.h>
 #include <core/scheduler.h>
+#include <core/steadystate.h>
+#include <utils/allocationcounter.h>
 #include <utils/logger.h>
 
+#include <utility>
 #include <vector>
 #include <sstream>
 
@@ -73,6 +78,7 @@ namespace tmssim {
     unsigned int esum;
     unsigned int cancelSteps;
     unsigned int idleSteps;
+    unsigned int peakJobs; ///< maximum number of jobs that existed at once
     Taskset* taskset;
     std::string schedulerId;
 
@@ -80,7 +86,80 @@ namespace tmssim {
   };
 
   std::ostream& operator<< (std::ostream& out, const SimulationResults& stat);
+
+
+  /**
+   * @brief Calls of the scheduler in the simulation loop.
+   *
+   * The calls are bound at compile time to the implementation of
+   * SchedulerT, which must be the dynamic type of the scheduler. The
+   * specialisation for Scheduler keeps the virtual calls.
+   */
+  template<class SchedulerT>
+  struct SchedulerCalls {
+    static int initStep(Scheduler* s, TmsTime now, ScheduleStat& scheduleStat) {
+      return static_cast<SchedulerT*>(s)->SchedulerT::initStep(now, scheduleStat);
+    }
+    static void enqueueJob(Scheduler* s, Job* job) {
+      static_cast<SchedulerT*>(s)->SchedulerT::enqueueJob(job);
+    }
+    static void enqueueJobs(Scheduler* s, const std::vector<Job*>& jobs) {
+      static_cast<SchedulerT*>(s)->SchedulerT::enqueueJobs(jobs);
+    }
+    static int schedule(Scheduler* s, TmsTime now, ScheduleStat& scheduleStat) {
+      return static_cast<SchedulerT*>(s)->SchedulerT::schedule(now, scheduleStat);
+    }
+    static Job* dispatch(Scheduler* s, TmsTime now, DispatchStat& dispatchStat) {
+      return static_cast<SchedulerT*>(s)->SchedulerT::dispatch(now, dispatchStat);
+    }
+    static TmsTime getNextEventTime(const Scheduler* s, TmsTime now) {
+      return static_cast<const SchedulerT*>(s)->SchedulerT::getNextEventTime(now);
+    }
+    static int advance(Scheduler* s, TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat) {
+      return static_cast<SchedulerT*>(s)->SchedulerT::advance(now, steps, dispatchStat);
+    }
+    static bool hasPendingJobs(const Scheduler* s) {
+      return static_cast<const SchedulerT*>(s)->SchedulerT::hasPendingJobs();
+    }
+  };
+
+
+  template<>
+  struct SchedulerCalls<Scheduler> {
+    static int initStep(Scheduler* s, TmsTime now, ScheduleStat& scheduleStat) {
+      return s->initStep(now, scheduleStat);
+    }
+    static void enqueueJob(Scheduler* s, Job* job) {
+      s->enqueueJob(job);
+    }
+    static void enqueueJobs(Scheduler* s, const std::vector<Job*>& jobs) {
+      s->enqueueJobs(jobs);
+    }
+    static int schedule(Scheduler* s, TmsTime now, ScheduleStat& scheduleStat) {
+      return s->schedule(now, scheduleStat);
+    }
+    static Job* dispatch(Scheduler* s, TmsTime now, DispatchStat& dispatchStat) {
+      return s->dispatch(now, dispatchStat);
+    }
+    static TmsTime getNextEventTime(const Scheduler* s, TmsTime now) {
+      return s->getNextEventTime(now);
+    }
+    static int advance(Scheduler* s, TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat) {
+      return s->advance(now, steps, dispatchStat);
+    }
+    static bool hasPendingJobs(const Scheduler* s) {
+      return s->hasPendingJobs();
+    }
+  };
+
   
+  /**
+   * @brief Simulation of a task set with a scheduler
+   *
+   * The scheduler and the task hooks are called virtually. For known
+   * combinations of scheduler and task model, BasicSimulation binds these
+   * calls at compile time.
+   */
   class Simulation {
   public:
 
@@ -98,6 +177,14 @@ namespace tmssim {
       EC_CANCEL = 0x4,
       EC_DISPATCH = 0x8
     };
+
+    /**
+     * @brief How the simulation advances in time
+     */
+    enum AdvanceMode {
+      AM_TICK, ///< simulate each single time step
+      AM_EVENT ///< skip over time steps in which no event can occur
+    };
          
     /**
      * @brief C'tor
@@ -112,7 +199,7 @@ namespace tmssim {
     /**
      * @brief D'tor
      */
-    ~Simulation();
+    virtual ~Simulation();
 
     
     /**
@@ -123,7 +210,7 @@ namespace tmssim {
      * an exit condition specified in the constructor); else, the encountered
      * exit condition is returned.
      */
-    Simulation::ExitCondition run(TmsTimeInterval steps);
+    virtual Simulation::ExitCondition run(TmsTimeInterval steps);
 
     /**
      * Finalise the simulation by executing all currently active jobs.
@@ -132,7 +219,7 @@ namespace tmssim {
      * an exit condition specified in the constructor); else, the encountered
      * exit condition is returned.
      */
-    Simulation::ExitCondition finalise();
+    virtual Simulation::ExitCondition finalise();
     
     /**
      * Get the current simulation results
@@ -148,7 +235,134 @@ namespace tmssim {
      */
     const Taskset* getTaskset() const;
 
-    TmsTime getTime() const { return now; }
+    /**
+     * @brief Get the pool from which the jobs of this simulation are
+     * allocated, e.g. to read the number of live jobs
+     */
+    const JobPool& getJobPool() const { return jobPool; }
+
+    /**
+     * @brief Get the execution statistics of the tasks, the slots are
+     * the indices of the tasks in the task set
+     */
+    const TaskStatsTable& getTaskStats() const { return taskStats; }
+
+    /**
+     * @return the simulated time, including the time steps that were
+     * extrapolated (see #setSteadyStateDetection)
+     */
+    TmsTime getTime() const { return now + timeOffset; }
+
+    bool isFinalised() const { return finalised; }
+
+    /**
+     * @brief Set how this simulation advances in time.
+     *
+     * In AM_EVENT mode, the simulation asks the tasks and the scheduler for
+     * the next event (activation, job completion, pending deadline miss)
+     * and executes the time steps up to that event at once. Simulation
+     * results are the same as in AM_TICK mode, but the EXEC log only
+     * contains one entry for each skipped interval.
+     * @param mode the advance mode
+     */
+    void setAdvanceMode(AdvanceMode mode) { advanceMode = mode; }
+
+    AdvanceMode getAdvanceMode() const { return advanceMode; }
+
+    /**
+     * @brief Set the advance mode of all subsequently created simulations.
+     * @param mode the advance mode, default is AM_TICK
+     */
+    static void setDefaultAdvanceMode(AdvanceMode mode);
+
+    /**
+     * @brief Enable the detection of periodic steady states in #run.
+     *
+     * At the boundaries of the hyperperiod (the least common multiple
+     * of the tasks' activation periods), the simulation takes a
+     * StateSnapshot of the scheduler and the tasks. Once a snapshot
+     * equals an earlier one, the simulation repeats the steps between
+     * them until the end of the run. The counters of the simulation are
+     * then advanced by the number of full repetitions that remain, and
+     * only the rest of the run is simulated. The results are the same
+     * as without detection.
+     *
+     * Detection is skipped if the scheduler or a task does not support
+     * it (see Scheduler::writeState and Task::writeState), and if EXEC,
+     * SIM, TASK or SCHED output is logged, because the log would miss
+     * the extrapolated steps. Lock-step runs are not covered.
+     * @param enable default is false
+     */
+    void setSteadyStateDetection(bool enable) { steadyStateDetection = enable; }
+
+    bool getSteadyStateDetection() const { return steadyStateDetection; }
+
+    /**
+     * @brief Set the steady-state detection of all subsequently created
+     * simulations.
+     */
+    static void setDefaultSteadyStateDetection(bool enable);
+
+    /**
+     * @return number of time steps that were extrapolated instead of
+     * simulated, included in #getTime
+     */
+    TmsTime getExtrapolatedTime() const { return timeOffset; }
+
+    /**
+     * @brief Set from which time step on the simulations check that
+     * their time steps do not allocate heap memory.
+     *
+     * The check is only performed if tms-sim is built with
+     * -DCOUNT_ALLOCATIONS=1 (see AllocationCounter), and if neither EXEC
+     * nor SIM output is logged. Before the warm-up has passed, the job
+     * pool and the queues of the scheduler may still grow.
+     * @param steps warm-up time, default is 1000
+     */
+    static void setAllocationWarmup(TmsTime steps);
+
+    /**
+     * @return number of time steps after the warm-up in which heap
+     * memory was allocated
+     */
+    unsigned long getAllocatingSteps() const { return allocatingSteps; }
+
+    /**
+     * @name Lock-step execution
+     * Used by LockstepSimulation, which advances several simulations of
+     * the same task set with one activation calendar. The activation
+     * calendar of the simulation itself is not used.
+     */
+    ///@{
+    /**
+     * @brief Simulate time step #now with the given activations, and
+     * go on to the next time step.
+     * @param dueTasks indices of the tasks that are activated in this
+     * step, in ascending order
+     * @return 0 on success, else the exit condition (#now is not
+     * advanced then, like in #run)
+     */
+    virtual ExitCondition lockstepStep(const std::vector<size_t>& dueTasks);
+
+    /**
+     * @brief Execute the time steps #now ... #now + steps - 1 at once,
+     * no event may occur in these steps (see #setAdvanceMode)
+     * @return 0 on success, else the exit condition
+     */
+    virtual ExitCondition lockstepAdvance(TmsTimeInterval steps);
+
+    /**
+     * @return time of the scheduler's next event after the last
+     * simulated time step, activations are not regarded
+     */
+    virtual TmsTime getNextSchedulerEventTime() const;
+
+    /**
+     * @brief Finish a lock-step run like #run
+     * @param ec exit condition of the run
+     */
+    void endLockstep(ExitCondition ec) { stats.success = ec == 0; }
+    ///@}
 
 
     class SimulationException {
@@ -161,6 +375,36 @@ namespace tmssim {
     };
 
 
+  protected:
+    /**
+     * @brief The simulation loop of #run
+     *
+     * The definitions of the member templates are in
+     * core/basicsimulation.h.
+     * @tparam SchedulerT dynamic type of #scheduler, or Scheduler
+     * @tparam TaskT dynamic type of all tasks, or Task
+     */
+    template<class SchedulerT, class TaskT>
+    ExitCondition runSteps(TmsTimeInterval steps);
+
+    /// @brief The loop of #finalise
+    template<class SchedulerT, class TaskT>
+    ExitCondition finaliseSteps();
+
+    /// @brief Implementation of #lockstepStep
+    template<class SchedulerT, class TaskT>
+    ExitCondition stepWith(const std::vector<size_t>& dueTasks);
+
+    /// @brief Implementation of #lockstepAdvance
+    template<class SchedulerT>
+    ExitCondition advanceBy(TmsTimeInterval steps);
+
+    /// @brief Implementation of #getNextSchedulerEventTime
+    template<class SchedulerT>
+    TmsTime nextSchedulerEvent() const {
+      return SchedulerCalls<SchedulerT>::getNextEventTime(scheduler, now - 1);
+    }
+
   private:   
     
     /**
@@ -171,6 +415,7 @@ namespace tmssim {
      * @brief Prepare scheduler for current step.
      *
      */
+    template<class SchedulerT, class TaskT>
     ExitCondition initStep();
     
     /**
@@ -182,7 +427,23 @@ namespace tmssim {
      * scheduling algorithm
      * @param log Outputstream to store log information in
      */
+    template<class SchedulerT, class TaskT>
     void doActivations();
+
+    /**
+     * @brief Spawn the jobs of the given tasks and hand them to the
+     * scheduler
+     * @param due indices of the tasks in #taskset, ascending
+     */
+    template<class SchedulerT, class TaskT>
+    void activateTasks(const std::vector<size_t>& due);
+
+    /**
+     * @brief Insert a task into the #activationCalendar at its next
+     * activation time
+     * @param taskNum index of the task in #taskset
+     */
+    void scheduleActivation(size_t taskNum);
     // @return true, if there are jobs to be executed, false otherwise
     // @todo return more elaborate error codes
     
@@ -198,8 +459,25 @@ namespace tmssim {
      * @return Errors that occurred during execution
      * @todo return more elaborate error codes
      */
+    template<class SchedulerT, class TaskT>
     ExitCondition doExecutions();
 
+    /**
+     * @brief Find the next time step in which an event might occur
+     * @return time of the next activation or scheduling event
+     */
+    template<class SchedulerT>
+    TmsTime getNextEventTime() const;
+
+    /**
+     * @brief Execute the current schedule for several time steps,
+     * starting at #now.
+     * @param steps number of time steps without any events
+     * @return Errors that occurred during execution
+     */
+    template<class SchedulerT>
+    ExitCondition doAdvance(TmsTimeInterval steps);
+
 
     /**
      * @brief Perfrom cancellations a scheduler decided on.
@@ -207,6 +485,7 @@ namespace tmssim {
      * @param scStat
      * @return Cancellation errors
      */
+    template<class TaskT>
     bool performCancellations(const ScheduleStat& scStat);
     
     /**
@@ -220,6 +499,39 @@ namespace tmssim {
      * Inits the delay counters variables. Should be called before using them.
      */
     void initCounters(void);
+
+    /**
+     * @brief Check whether the current time step allocated heap memory
+     * @param before allocation count at the begin of the step
+     */
+    void checkAllocations(unsigned long before) {
+      if (AllocationCounter::getCount() != before && now >= allocationWarmup)
+	reportAllocations(AllocationCounter::getCount() - before);
+    }
+
+    /// @brief Count and report a time step that allocated heap memory
+    void reportAllocations(unsigned long n);
+
+    /**
+     * @brief Prepare steady-state detection for a run
+     * @return time of the first check, TMS_TIME_MAX if there is none
+     */
+    TmsTime startSteadyStateDetection();
+
+    /**
+     * @brief Compare the state at #now with an earlier snapshot, and skip
+     * the remaining repetitions if the state repeats (Brent's cycle
+     * detection)
+     * @param end end of the run, moved forward by the skipped steps
+     * @return time of the next check, TMS_TIME_MAX if there is none
+     */
+    TmsTime checkSteadyState(TmsTime& end);
+
+    /// @return false if the scheduler or a task cannot write its state
+    bool writeState(StateSnapshot& snapshot) const;
+
+    /// @brief Visit all cumulative values of the simulation
+    void visitCounters(CounterVisitor& visitor);
     
     /**
      * Prints information about the delay counters to the console.
@@ -285,17 +597,72 @@ namespace tmssim {
      */
     int idleSteps;
 
+    /// Time steps after the warm-up that allocated heap memory
+    unsigned long allocatingSteps;
+
+    /// Warm-up time before allocations are checked
+    static TmsTime allocationWarmup;
+
+    SimulationResults stats;
+
+    /// Next activation time and index of a task
+    typedef std::pair<TmsTime, size_t> CalendarEntry;
+
     /**
-     * Numbers of the steps in which cancellations happened
+     * Min-heap of the tasks' next activations, so each step only visits
+     * the tasks that are due
      */
-    std::list<int> cancelStepList;
+    std::vector<CalendarEntry> activationCalendar;
 
-    SimulationResults stats;
+    /// Tasks that are activated in the current step (reused buffer)
+    std::vector<size_t> dueTasks;
+
+    /// Jobs that were activated in the current step (reused buffer)
+    std::vector<Job*> activatedJobs;
+
+    /// Passed to all scheduler calls, so its vector keeps its memory
+    ScheduleStat scheduleStat;
+
+    /// The jobs of all tasks are allocated from this pool
+    JobPool jobPool;
+
+    /// The tasks record their execution statistics here
+    TaskStatsTable taskStats;
 
     /// Current time of simulation
     TmsTime now;
     
     bool finalised;
+
+    /// How this simulation advances in time
+    AdvanceMode advanceMode;
+
+    /// Advance mode for new simulations
+    static AdvanceMode defaultAdvanceMode;
+
+    /// Detect steady states in #run
+    bool steadyStateDetection;
+
+    /// Steady-state detection for new simulations
+    static bool defaultSteadyStateDetection;
+
+    /// Distance of the steady-state checks, 0 if not supported
+    TmsTimeInterval hyperperiod;
+
+    /// Time of the next steady-state check within the current run
+    TmsTime nextStateCheck;
+
+    /// Earlier snapshot and current snapshot of the state
+    StateSnapshot tortoise;
+    StateSnapshot current;
+
+    /// Cycle detection: checks since #tortoise was taken, and the
+    /// number of checks after which #tortoise is moved on
+    unsigned long lambda;
+    unsigned long power;
+
+    /// Time steps that were extrapolated, not included in #now
+    TmsTime timeOffset;
     
   };
   
@@ -0,0 +1,163 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file steadystate.cpp
+ * @brief Snapshots of the simulation state for steady-state detection
+ */
+
+#include <core/steadystate.h>
+#include <core/job.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace tmssim {
+
+  /// Integers up to this magnitude are exactly representable as double
+  static const double MAX_EXACT_DOUBLE = 9007199254740992.0; // 2^53
+
+
+  StateSnapshot::StateSnapshot()
+    : now(0) {
+  }
+
+
+  void StateSnapshot::begin(TmsTime _now) {
+    now = _now;
+    state.clear();
+    counts.clear();
+    sums.clear();
+  }
+
+
+  void StateSnapshot::addValue(double value) {
+    int64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "double must have 64 bits");
+    memcpy(&bits, &value, sizeof(bits));
+    state.push_back(bits);
+  }
+
+
+  void StateSnapshot::addJob(const Job* job) {
+    addJobRef(job);
+    if (job == NULL)
+      return;
+    add(job->getExecutionTime());
+    add(job->getRemainingExecutionTime());
+    addTime(job->getAbsDeadline());
+    addTime(job->getLatestStartTime());
+    add(job->getPriority());
+    add(job->getPreemptions());
+  }
+
+
+  void StateSnapshot::addJobRef(const Job* job) {
+    if (job == NULL) {
+      addObject(NULL);
+    }
+    else {
+      // a task activates at most one job per time step
+      addObject(job->getTask());
+      addTime(job->getActivationTime());
+    }
+  }
+
+
+  void StateSnapshot::swap(StateSnapshot& rhs) {
+    std::swap(now, rhs.now);
+    state.swap(rhs.state);
+    counts.swap(rhs.counts);
+    sums.swap(rhs.sums);
+  }
+
+
+  bool StateSnapshot::canExtrapolate(const StateSnapshot& from, int64_t n) const {
+    if (counts.size() != from.counts.size() || sums.size() != from.sums.size())
+      return false;
+    for (size_t i = 0; i < sums.size(); ++i) {
+      double a = from.sums[i];
+      double b = sums[i];
+      if (a != std::floor(a) || b != std::floor(b))
+	return false;
+      if (std::fabs(b) + std::fabs(b - a) * n >= MAX_EXACT_DOUBLE)
+	return false;
+    }
+    return true;
+  }
+
+
+  void StateSnapshot::Recorder::visit(int& counter) {
+    snapshot.counts.push_back(counter);
+  }
+
+
+  void StateSnapshot::Recorder::visit(unsigned int& counter) {
+    snapshot.counts.push_back(counter);
+  }
+
+
+  void StateSnapshot::Recorder::visit(TmsTime& counter) {
+    snapshot.counts.push_back(counter);
+  }
+
+
+  void StateSnapshot::Recorder::visit(double& sum) {
+    snapshot.sums.push_back(sum);
+  }
+
+
+  StateSnapshot::Extrapolator::Extrapolator(const StateSnapshot& _from,
+					    const StateSnapshot& _to,
+					    int64_t _n)
+    : from(_from), to(_to), n(_n), nextCounter(0), nextSum(0) {
+  }
+
+
+  int64_t StateSnapshot::Extrapolator::nextCount() {
+    assert(nextCounter < to.counts.size());
+    size_t i = nextCounter++;
+    return to.counts[i] + n * (to.counts[i] - from.counts[i]);
+  }
+
+
+  void StateSnapshot::Extrapolator::visit(int& counter) {
+    counter = nextCount();
+  }
+
+
+  void StateSnapshot::Extrapolator::visit(unsigned int& counter) {
+    counter = nextCount();
+  }
+
+
+  void StateSnapshot::Extrapolator::visit(TmsTime& counter) {
+    counter = nextCount();
+  }
+
+
+  void StateSnapshot::Extrapolator::visit(double& sum) {
+    assert(nextSum < to.sums.size());
+    size_t i = nextSum++;
+    sum = to.sums[i] + n * (to.sums[i] - from.sums[i]);
+  }
+
+} // NS tmssim
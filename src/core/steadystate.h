@@ -0,0 +1,172 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file steadystate.h
+ * @brief Snapshots of the simulation state for steady-state detection
+ */
+
+#ifndef CORE_STEADYSTATE_H
+#define CORE_STEADYSTATE_H 1
+
+#include <core/primitives.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tmssim {
+
+  class Job;
+
+
+  /**
+   * @brief Visits the cumulative values of a simulation, i.e. counters
+   * and sums that only grow and do not influence the further course of
+   * the simulation.
+   */
+  class CounterVisitor {
+  public:
+    virtual ~CounterVisitor() {}
+    virtual void visit(int& counter) = 0;
+    virtual void visit(unsigned int& counter) = 0;
+    virtual void visit(TmsTime& counter) = 0;
+    virtual void visit(double& sum) = 0;
+  };
+
+
+  /**
+   * @brief Snapshot of the state of a simulation at one point in time
+   *
+   * The scheduler and the tasks write all state that determines how the
+   * simulation continues: the pending jobs, the order of the scheduler's
+   * queues, the histories of the tasks. Points in time are stored
+   * relative to the time of the snapshot. Thus, if two snapshots of a
+   * simulation have the same state, the simulation repeats the steps
+   * between them forever, and each repetition changes the cumulative
+   * values (see CounterVisitor) by the same amount.
+   *
+   * Objects are identified by their address, so only snapshots of the
+   * same simulation may be compared.
+   */
+  class StateSnapshot {
+  public:
+    StateSnapshot();
+
+    /**
+     * @brief Start a new snapshot, the previous contents are discarded
+     * @param _now time of the snapshot
+     */
+    void begin(TmsTime _now);
+
+    TmsTime getTime() const { return now; }
+
+    /// @name Writing the state
+    ///@{
+    void add(int64_t value) { state.push_back(value); }
+
+    /// @brief Add a point in time
+    void addTime(TmsTime time) { state.push_back(time - now); }
+
+    /// @brief Add a floating point value, which is compared exactly
+    void addValue(double value);
+
+    /// @brief Add an object that is identified by its address
+    void addObject(const void* object) { state.push_back((int64_t) (intptr_t) object); }
+
+    /// @brief Add the complete state of a job
+    void addJob(const Job* job);
+
+    /**
+     * @brief Add a reference to a job whose state was already added, or
+     * NULL
+     */
+    void addJobRef(const Job* job);
+    ///@}
+
+    /// @return true if the state of both snapshots is the same
+    bool sameState(const StateSnapshot& rhs) const { return state == rhs.state; }
+
+    /// @brief Exchange the contents, without copying
+    void swap(StateSnapshot& rhs);
+
+    /**
+     * @brief Check whether the cumulative values can be extrapolated
+     * exactly from an earlier snapshot with the same state.
+     *
+     * This is the case for all integer counters. Sums of floating point
+     * values are only extrapolated if they are integral (like the sums of
+     * firm real-time utilities), because otherwise the result would
+     * depend on the order of the additions.
+     * @param from the earlier snapshot
+     * @param n number of repetitions to extrapolate
+     */
+    bool canExtrapolate(const StateSnapshot& from, int64_t n) const;
+
+    /**
+     * @brief Records the visited values in a snapshot
+     */
+    class Recorder : public CounterVisitor {
+    public:
+      Recorder(StateSnapshot& _snapshot) : snapshot(_snapshot) {}
+      virtual void visit(int& counter);
+      virtual void visit(unsigned int& counter);
+      virtual void visit(TmsTime& counter);
+      virtual void visit(double& sum);
+    private:
+      StateSnapshot& snapshot;
+    };
+
+    /**
+     * @brief Advances the visited values by n times their increase from
+     * one snapshot to the other; the values must be the ones recorded
+     * in the later snapshot.
+     */
+    class Extrapolator : public CounterVisitor {
+    public:
+      Extrapolator(const StateSnapshot& _from, const StateSnapshot& _to,
+		   int64_t _n);
+      virtual void visit(int& counter);
+      virtual void visit(unsigned int& counter);
+      virtual void visit(TmsTime& counter);
+      virtual void visit(double& sum);
+    private:
+      int64_t nextCount();
+      const StateSnapshot& from;
+      const StateSnapshot& to;
+      int64_t n;
+      /// index of the next integer counter
+      size_t nextCounter;
+      /// index of the next sum
+      size_t nextSum;
+    };
+
+  private:
+    TmsTime now;
+    std::vector<int64_t> state;
+    /// integer counters in the order of visiting
+    std::vector<int64_t> counts;
+    /// floating point sums in the order of visiting
+    std::vector<double> sums;
+  };
+
+} // NS tmssim
+
+#endif // !CORE_STEADYSTATE_H
@@ -30,6 +30,8 @@
 
 #include <task.h>
 #include <core/job.h>
+#include <core/jobpool.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 
 #include <cassert>
@@ -45,40 +47,34 @@ namespace tmssim {
 	     TmsTimeInterval __relDeadline,
 	     UtilityCalculator* __uc, UtilityAggregator* __ua,
 	     TmsPriority __priority)
+    : Task(TaskSpecPtr(new TaskSpec(__id, __executionTime, __relDeadline, __uc)),
+	   __ua, __priority)
+  {
+    assert(__uc != NULL);
+  }
+
+
+  Task::Task(const TaskSpecPtr& __spec, UtilityAggregator* __ua,
+	     TmsPriority __priority)
     :
-    id(_id), executionTime(_executionTime), relDeadline(_relDeadline), priority(_priority),
-    activations(_activations), completions(_completions),
-    cancellations(_cancellations), misses(_misses), preemptions(_preemptions),
-    _id(__id), _executionTime(__executionTime), _relDeadline(__relDeadline),
-      _uc(__uc), _ua(__ua), _activations(0),
-    _completions(0), _cancellations(0), _misses(0), _preemptions(0),
-    _execCancellations(0), _priority(__priority), _nextActivation(-1),
-    _lastValue(1), delayCounter(0)//, currentSize(0)
+    id(__spec->id), executionTime(__spec->executionTime),
+    relDeadline(__spec->relDeadline), priority(_priority),
+    _spec(__spec), _stats(NULL), _slot(0), _ownStats(NULL), _ua(__ua),
+    _priority(__priority), _jobPool(NULL)
   {
-    assert(_uc != NULL);
     assert(_ua != NULL);
   }
   
   
   Task::~Task(void) {
-    delete _uc;
     delete _ua;
+    delete _ownStats;
   }
 
 
   Task::Task(const Task& rhs)
-    :
-    id(_id), executionTime(_executionTime), relDeadline(_relDeadline), priority(_priority),
-    activations(_activations), completions(_completions),
-    cancellations(_cancellations), misses(_misses), preemptions(_preemptions),
-    _id(rhs._id), _executionTime(rhs._executionTime), _relDeadline(rhs._relDeadline),  _activations(0),
-    _completions(0), _cancellations(0), _misses(0), _preemptions(0),
-    _execCancellations(0), _priority(rhs._priority), _nextActivation(-1),
-    _lastValue(1), delayCounter(0)//, currentSize(0)
+    : Task(rhs._spec, rhs._ua->clone(), rhs._priority)
   {
-    //_uc(__uc), _ua(__ua),
-    _uc = rhs._uc->clone();
-    _ua = rhs._ua->clone();
   }
   
   
@@ -99,12 +95,12 @@ namespace tmssim {
   
   
   TmsTimeInterval Task::getExecutionTime(void) const {
-    return _executionTime;
+    return executionTime;
   }
 
 
   TmsTimeInterval Task::getRelativeDeadline(void) const {
-    return _relDeadline;
+    return relDeadline;
   }
   
 
@@ -114,22 +110,22 @@ namespace tmssim {
 
   
   void Task::start(TmsTime now) {
-    _nextActivation = startHook(now);
-    _activations = 0;
-    _completions = 0;
-    _cancellations = 0;
-    _execCancellations = 0;
-    _ecPerformanceLost = 0;
-    _misses = 0;
-    _preemptions = 0;
+    if (_stats == NULL) {
+      _ownStats = new TaskStatsTable(1);
+      setStatsSlot(_ownStats, 0);
+    }
+    _state.reset(startHook(now));
+    _stats->reset(_slot);
+    recordUtility();
   }
   
   
   Job* Task::spawnJob(TmsTime now) {
-    if (now >= _nextActivation) {
+    if (now >= _state.nextActivation) {
+      JobPool::Scope scope(_jobPool);
       Job* job = spawnHook(now);
-      _nextActivation += getNextActivationOffset(now);
-      _activations++;
+      _state.nextActivation += getNextActivationOffset(now);
+      _stats->activations[_slot]++;
       return job;
     }
     else {
@@ -138,37 +134,72 @@ namespace tmssim {
   }
   
   
+  TmsTime Task::getNextActivation(void) const {
+    return _state.nextActivation;
+  }
+
+
   void Task::completeJob(Job* job, TmsTime now) {
     if (job == NULL) return;
-    _completions++;
+    recordCompletion(job, now);
+    completionHook(job, now);
+  }
+
+
+  void Task::recordCompletion(Job* job, TmsTime now) {
+    _stats->completions[_slot]++;
     if (job->getAbsDeadline() < now) {
-      _misses++;
+      _stats->misses[_slot]++;
     }
-    _preemptions += job->getPreemptions();
-    _lastValue = _uc->calcUtility(job, now);
-    _ua->addUtility(_lastValue);
-    record(_lastValue);
+    _stats->preemptions[_slot] += job->getPreemptions();
+    _state.lastValue = _spec->uc->calcUtility(job, now);
+    _ua->addUtility(_state.lastValue);
+    recordUtility();
+    record(_state.lastValue);
     //cout << "Complete " << *this << " " << *job << endl;
-    completionHook(job, now);
   }
   
   
   bool Task::cancelJob(Job* job) {
     if (job == NULL) return true;
-    _preemptions += job->getPreemptions();
-    ++_cancellations;
+    recordCancellation(job);
+    return cancelHook(job);
+  }
+
+
+  void Task::recordCancellation(Job* job) {
+    _stats->preemptions[_slot] += job->getPreemptions();
+    ++_stats->cancellations[_slot];
     if (job->getRemainingExecutionTime() < job->getExecutionTime()) {
-      ++_execCancellations;
-      _ecPerformanceLost += job->getExecutionTime() - job->getRemainingExecutionTime();
+      ++_stats->execCancellations[_slot];
+      _stats->ecPerformanceLost[_slot] += job->getExecutionTime() - job->getRemainingExecutionTime();
     }
-    _lastValue = 0;
-    _ua->addUtility(_lastValue);
-    record(_lastValue);
+    _state.lastValue = 0;
+    _ua->addUtility(_state.lastValue);
+    recordUtility();
+    record(_state.lastValue);
     //cout << "Cancel " << *this << " " << *job << endl;
-    return cancelHook(job);
+  }
+
+
+  void Task::recordUtility() {
+    _stats->usum[_slot] = _ua->getTotal();
+    _stats->esum[_slot] = _ua->getCount();
   }
   
   
+  void Task::setJobPool(JobPool* pool) {
+    _jobPool = pool;
+  }
+
+
+  void Task::setStatsSlot(TaskStatsTable* table, size_t slot) {
+    assert(table != NULL && slot < table->size());
+    _stats = table;
+    _slot = slot;
+  }
+
+
   std::ostream& Task::print(std::ostream& ost) const {
     ost << getIdString() << "(" << executionTime << ")";
     return ost;
@@ -186,11 +217,11 @@ namespace tmssim {
 
 
   int Task::writeData(xmlTextWriterPtr writer) {
-    xmlTextWriterWriteElement(writer, (xmlChar*)"id", STRTOXML(XmlUtils::convertToXML<int>(_id)));
-    xmlTextWriterWriteElement(writer, (xmlChar*)"executiontime", STRTOXML(XmlUtils::convertToXML<int>(_executionTime)));
-    xmlTextWriterWriteElement(writer, (xmlChar*)"criticaltime", STRTOXML(XmlUtils::convertToXML<int>(_relDeadline)));
+    xmlTextWriterWriteElement(writer, (xmlChar*)"id", STRTOXML(XmlUtils::convertToXML<int>(id)));
+    xmlTextWriterWriteElement(writer, (xmlChar*)"executiontime", STRTOXML(XmlUtils::convertToXML<int>(executionTime)));
+    xmlTextWriterWriteElement(writer, (xmlChar*)"criticaltime", STRTOXML(XmlUtils::convertToXML<int>(relDeadline)));
     //_uc->write(writer);
-    _uc->writeToXML(writer);
+    _spec->uc->writeToXML(writer);
     //_ua->write(writer);
     _ua->writeToXML(writer);
     xmlTextWriterWriteElement(writer, (xmlChar*)"priority", STRTOXML(XmlUtils::convertToXML<int>(_priority)));
@@ -206,12 +237,12 @@ namespace tmssim {
   
   
   double Task::getPossibleExecValue(const Job *job, TmsTime startTime) const {
-    return _uc->calcUtility(job, startTime + job->getRemainingExecutionTime());
+    return _spec->uc->calcUtility(job, startTime + job->getRemainingExecutionTime());
   }
   
   
   double Task::getPossibleHistoryValue(const Job *job, TmsTime startTime) const {
-    return _ua->predictUtility(_uc->calcUtility(job, startTime + job->getRemainingExecutionTime()));
+    return _ua->predictUtility(_spec->uc->calcUtility(job, startTime + job->getRemainingExecutionTime()));
   }
   
   
@@ -220,48 +251,13 @@ namespace tmssim {
   }
   
   
-  int Task::getActivations(void) const {
-    return _activations;
-  }
-  
-  
-  int Task::getCompletions(void) const {
-    return _completions;
-  }
-  
-  
-  int Task::getCancellations(void) const {
-    return _cancellations;
-  }
-  
-  
-  int Task::getMisses(void) const {
-    return _misses;
-  }
-  
-  
-  int Task::getPreemptions(void) const {
-    return _preemptions;
-  }
-  
-  
-  int Task::getExecCancellations(void) const {
-    return _execCancellations;
-  }
-  
-
-  TmsTime Task::getEcPerformanceLost(void) const {
-    return _ecPerformanceLost;
-  }
-
-  
   const UtilityAggregator* Task::getUA() const {
     return _ua;
   }
 
   
   const UtilityCalculator* Task::getUC() const {
-    return _uc;
+    return _spec->uc;
   }
   
   
@@ -273,7 +269,7 @@ namespace tmssim {
     
   
   double Task::getLastExecValue(void) const {
-    return _lastValue;
+    return _state.lastValue;
   }
   
   
@@ -293,23 +289,56 @@ namespace tmssim {
   
 
   const std::vector<int>& Task::getCounters(void) const {
-    return delayCounters;
+    return _state.delayCounters;
   }
   
+  bool Task::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
+
+
+  bool Task::writeTaskState(StateSnapshot& snapshot) const {
+    snapshot.addTime(_state.nextActivation);
+    snapshot.addValue(_state.lastValue);
+    snapshot.add(_state.delayCounter);
+    // a new entry changes the state, the entries themselves are counters
+    snapshot.add(_state.delayCounters.size());
+    return _ua->writeState(snapshot);
+  }
+
+
+  void Task::visitCounters(CounterVisitor& visitor) {
+    for (int& counter: _state.delayCounters) {
+      visitor.visit(counter);
+    }
+    _ua->visitCounters(visitor);
+  }
+
+
+  TmsTimeInterval Task::getActivationPeriod() const {
+    return 0;
+  }
+
+
   void Task::recordDelay() {
-    ++delayCounter;
+    ++_state.delayCounter;
   }
   
   
   void Task::recordNoDelay() {
-    if (delayCounter <= 0) {
+    if (_state.delayCounter <= 0) {
       return;
     }
-    if (delayCounters.size() < delayCounter) {
-      delayCounters.resize(delayCounter, 0);
+    if (_state.delayCounters.size() < _state.delayCounter) {
+      _state.delayCounters.resize(_state.delayCounter, 0);
     }
-    delayCounters[delayCounter-1]++;
-    delayCounter = 0;
+    _state.delayCounters[_state.delayCounter-1]++;
+    _state.delayCounter = 0;
+  }
+
+
+  void Task::reserveDelayCounters(size_t n) {
+    _state.delayCounters.reserve(n);
   }
   
   /*
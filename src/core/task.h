@@ -29,6 +29,9 @@
 
 #include <core/primitives.h>
 
+#include <core/jobpool.h>
+#include <core/taskspec.h>
+#include <core/taskstatstable.h>
 #include <core/writeabletoxml.h>
 //#include <core/iwriteabletoxml.h>
 
@@ -39,6 +42,9 @@
 
 namespace tmssim {
 
+  class CounterVisitor;
+  class StateSnapshot;
+
   /**
    * @class Task
    * @brief Abstract task provides a general interface that is used for scheduling
@@ -56,6 +62,12 @@ namespace tmssim {
    * a problem if we have special types of tasks that need rather special
    * utility management.
    * - move statistics into separate object
+   *
+   * The immutable parameters of a task are kept in a TaskSpec that is
+   * shared by all copies of the task, its execution state in a
+   * TaskState. The execution counters are recorded in a slot of a
+   * TaskStatsTable, usually the one of the simulation (see
+   * #setStatsSlot).
    */
   class Task
     : //public IWriteableToXML,
@@ -82,11 +94,24 @@ namespace tmssim {
     Task(unsigned int __id, TmsTime __executionTime,
 	 TmsTimeInterval __relDeadline, UtilityCalculator* __uc,
 	 UtilityAggregator* __ua, TmsPriority __priority);
+
+    /**
+     * Constructor for tasks that share their parameters with other tasks
+     * @param __spec the task parameters
+     * @param __ua pass a pointer to a newly allocated UtilityAggregator,
+     * see above
+     * @param __priority static priority of the task
+     */
+    Task(const TaskSpecPtr& __spec, UtilityAggregator* __ua,
+	 TmsPriority __priority);
     
     /// D'tor
     virtual ~Task(void);
 
-    /// Copy Constructor
+    /**
+     * Copy Constructor, the copy shares the TaskSpec of rhs and starts
+     * with a fresh TaskState
+     */
     Task(const Task& rhs);
 
     // this one is already contained in ICloneable
@@ -117,6 +142,9 @@ namespace tmssim {
     /// @return the critical time (=deadline) of the task
     TmsTimeInterval getRelativeDeadline(void) const;
 
+    /// @return the parameters of the task
+    const TaskSpecPtr& getSpec() const { return _spec; }
+
     /**
      * @return the task's utility calculator
      */
@@ -148,8 +176,9 @@ namespace tmssim {
     /**
       Prepare the task for execution.
       This function should be called any time an execution trace is generated
-      freshly. It will call the #tmssim::Task::startHook, where user
-      implementations can (re)initialise their data.
+      freshly. It resets the statistics and will call the
+      #tmssim::Task::startHook, where user implementations can
+      (re)initialise their data.
       @param now starting time of simulation, usually 0
     */
     void start(TmsTime now=0);
@@ -163,6 +192,12 @@ namespace tmssim {
     */
     Job* spawnJob(TmsTime now);
 
+    /**
+      Get the time at which #tmssim::Task::spawnJob will next spawn a job.
+      @return time of the next activation
+    */
+    TmsTime getNextActivation(void) const;
+
     /**
       Notify a task that one of its jobs has completed.
       This method is called any by the simulation environment any time a job
@@ -183,6 +218,38 @@ namespace tmssim {
      * @todo add time stamp?
      */
     bool cancelJob(Job* job);
+
+    /**
+     * @name Statically bound task execution control
+     * These methods behave like #spawnJob, #completeJob and #cancelJob,
+     * but call the hooks of TaskT directly instead of through the
+     * vtable. TaskT must be the dynamic type of the task, and it must
+     * declare Task as friend to give access to its hooks. With TaskT =
+     * Task, the hooks are called virtually. Used by BasicSimulation.
+     */
+    ///@{
+    template<class TaskT> Job* spawnJobAs(TmsTime now);
+    template<class TaskT> void completeJobAs(Job* job, TmsTime now);
+    template<class TaskT> bool cancelJobAs(Job* job);
+    ///@}
+
+    /**
+     * Set the pool from which #spawnJob allocates new jobs.
+     * Completed and cancelled jobs return to their pool when they are
+     * deleted by the task's hooks.
+     * @param pool the pool, NULL to allocate jobs from the heap
+     */
+    void setJobPool(JobPool* pool);
+
+    /**
+     * Set where the task records its execution statistics, must be
+     * called before #start. If no slot is set, #start allocates a
+     * table for the task itself.
+     * @param table the table, must live at least as long as the task is
+     * simulated
+     * @param slot index of the task in the table
+     */
+    void setStatsSlot(TaskStatsTable* table, size_t slot);
     ///@}
 
 
@@ -190,44 +257,52 @@ namespace tmssim {
     ///@{
     /**
       @return the number of activations of this task
-      @todo move to statistics class
     */
-    int getActivations(void) const;
+    int getActivations(void) const {
+      return _stats != NULL ? _stats->activations[_slot] : 0;
+    }
 
     /**
       @return the number the task was completed (including deadline misses)
-      @todo move to statistics class
     */
-    int getCompletions(void) const;
+    int getCompletions(void) const {
+      return _stats != NULL ? _stats->completions[_slot] : 0;
+    }
 
     /**
       @return the number of task instances (jobs) that were cancelled
-      @todo move to statistics class
     */
-    int getCancellations(void) const;
+    int getCancellations(void) const {
+      return _stats != NULL ? _stats->cancellations[_slot] : 0;
+    }
 
     /**
       @return the number of deadline misses
-      @todo move to statistics class
     */
-    int getMisses(void) const;
+    int getMisses(void) const {
+      return _stats != NULL ? _stats->misses[_slot] : 0;
+    }
 
     /**
       @return the number of preemptions any job of this task incurred
-      @todo move to statistics class
     */
-    int getPreemptions(void) const;
+    int getPreemptions(void) const {
+      return _stats != NULL ? _stats->preemptions[_slot] : 0;
+    }
 
     /**
       @return number of cancellation after job started execution
-      @todo move to statistics class
     */
-    int getExecCancellations(void) const;
+    int getExecCancellations(void) const {
+      return _stats != NULL ? _stats->execCancellations[_slot] : 0;
+    }
 
     /**
      * @return Number of execution cycles lost due to exec cancellations
      */
-    TmsTime getEcPerformanceLost(void) const;
+    TmsTime getEcPerformanceLost(void) const {
+      return _stats != NULL ? _stats->ecPerformanceLost[_slot] : 0;
+    }
     
     /**
       @return the counters of successive cancellations
@@ -235,6 +310,33 @@ namespace tmssim {
     const std::vector<int>& getCounters(void) const;
     ///@}
 
+    /// @name Steady-state detection
+    ///@{
+    /**
+     * @brief Write the complete state of the task that determines its
+     * future behaviour, see Simulation::setSteadyStateDetection.
+     *
+     * The default implementation returns false, which disables
+     * steady-state detection. Task models that support it write at
+     * least the state of #writeTaskState.
+     * @return true if the state was written
+     */
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
+    /**
+     * @brief Visit the cumulative values of the task that are not part
+     * of its TaskStatsTable slot. Override this if a subclass adds
+     * further counters.
+     */
+    virtual void visitCounters(CounterVisitor& visitor);
+
+    /**
+     * @brief Get the period with which the task's activations repeat
+     * @return the period, or 0 if the activations are not periodic
+     */
+    virtual TmsTimeInterval getActivationPeriod() const;
+    ///@}
+
     /// @name Task and job utilities
     ///@{
     /**
@@ -379,16 +481,6 @@ namespace tmssim {
     const TmsTimeInterval& relDeadline; ///< fast ro access to critical time
     const TmsPriority& priority; ///< fast ro access
     /// @}
-
-    // STATISTICS
-    /// @name Fast access to execution statistics
-    /// @{
-    const int& activations; ///< fast ro access @todo move to statistics class
-    const int& completions; ///< fast ro access @todo move to statistics class
-    const int& cancellations; ///< fast ro access @todo move to statistics class
-    const int& misses; ///< fast ro access @todo move to statistics class
-    const int& preemptions; ///< fast ro access @todo move to statistics class
-    /// @}
     
     /**
       Notify the delay counter about a finished job execution.
@@ -405,31 +497,91 @@ namespace tmssim {
     void recordDelay();
     /// record a successful job execution
     void recordNoDelay();
+    /**
+     * Reserve memory for the counters of successive delays, so that
+     * runs of up to @p n delays are recorded without allocating.
+     * @param n expected length of the longest run of delays
+     */
+    void reserveDelayCounters(size_t n);
+
+    /**
+     * Write the state that is kept by Task itself: the next activation,
+     * the last utility, the current delay counter and the state of the
+     * UtilityAggregator.
+     * @return false if the UtilityAggregator does not support
+     * steady-state detection
+     */
+    bool writeTaskState(StateSnapshot& snapshot) const;
     
   private:
-    unsigned int _id; ///< task id
-    TmsTimeInterval _executionTime; ///< execution time
-    TmsTimeInterval _relDeadline; ///< relative critical time
-    UtilityCalculator* _uc; ///< the task's UtilityCalculator
+    /// Statistics of #completeJob, without the hook
+    void recordCompletion(Job* job, TmsTime now);
+    /// Statistics of #cancelJob, without the hook
+    void recordCancellation(Job* job);
+    /// Copy the totals of #_ua into the statistics slot
+    void recordUtility();
+
+
+    TaskSpecPtr _spec; ///< task parameters, shared with copies of the task
+    TaskState _state; ///< execution state
+    TaskStatsTable* _stats; ///< execution statistics are recorded here
+    size_t _slot; ///< index of the task in #_stats
+    TaskStatsTable* _ownStats; ///< table of a task outside a simulation
     UtilityAggregator* _ua; ///< the task's UtilityAggregator
-    int _activations; ///< @todo move to statistics class
-    int _completions; ///< @todo move to statistics class
-    int _cancellations; ///< @todo move to statistics class
-    int _misses; ///< @todo move to statistics class
-    int _preemptions; ///< @todo move to statistics class
-    int _execCancellations; ///< count cancellations after task started execution @todo move to statistics class
-    TmsTime _ecPerformanceLost; ///< cycles lost due to exec cancellations
     TmsPriority _priority; ///< task (static) priority
-    TmsTime _nextActivation; ///< when will the next job be generated?
-    
-    double _lastValue; ///< utility of last job execution
-    
-    // Delay counter statistics members
-    size_t delayCounter; ///< counts current successive delays/cancellations
-    std::vector<int> delayCounters;
-    //size_t currentSize; // FIXME: remove
+    JobPool* _jobPool; ///< new jobs are allocated from this pool
   };
 
+  template<class TaskT>
+  inline Job* Task::spawnJobAs(TmsTime now) {
+    if (now >= _state.nextActivation) {
+      JobPool::Scope scope(_jobPool);
+      TaskT* self = static_cast<TaskT*>(this);
+      Job* job = self->TaskT::spawnHook(now);
+      _state.nextActivation += self->TaskT::getNextActivationOffset(now);
+      _stats->activations[_slot]++;
+      return job;
+    }
+    else {
+      return NULL;
+    }
+  }
+
+
+  template<class TaskT>
+  inline void Task::completeJobAs(Job* job, TmsTime now) {
+    if (job == NULL) return;
+    recordCompletion(job, now);
+    static_cast<TaskT*>(this)->TaskT::completionHook(job, now);
+  }
+
+
+  template<class TaskT>
+  inline bool Task::cancelJobAs(Job* job) {
+    if (job == NULL) return true;
+    recordCancellation(job);
+    return static_cast<TaskT*>(this)->TaskT::cancelHook(job);
+  }
+
+
+  template<>
+  inline Job* Task::spawnJobAs<Task>(TmsTime now) {
+    return spawnJob(now);
+  }
+
+
+  template<>
+  inline void Task::completeJobAs<Task>(Job* job, TmsTime now) {
+    completeJob(job, now);
+  }
+
+
+  template<>
+  inline bool Task::cancelJobAs<Task>(Job* job) {
+    return cancelJob(job);
+  }
+
+
   typedef std::vector<Task*> Taskset;
 
   std::ostream& operator << (std::ostream& ost, const Task& task);
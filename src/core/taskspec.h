@@ -0,0 +1,101 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file taskspec.h
+ * @brief Immutable parameters and mutable execution state of a task
+ */
+
+#ifndef CORE_TASKSPEC_H
+#define CORE_TASKSPEC_H 1
+
+#include <core/primitives.h>
+#include <core/utilitycalculator.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Immutable parameters of a Task
+   *
+   * All copies of a task (e.g. one for each scheduler that is evaluated)
+   * refer to the same TaskSpec through a TaskSpecPtr, so copying a task
+   * does not copy its parameters and does not clone its
+   * UtilityCalculator. UtilityCalculators only compute the utility of
+   * single jobs and have no state, so they can be shared.
+   */
+  struct TaskSpec {
+    /**
+     * @param _uc the TaskSpec takes ownership of the calculator
+     */
+    TaskSpec(unsigned int _id, TmsTimeInterval _executionTime,
+	     TmsTimeInterval _relDeadline, UtilityCalculator* _uc)
+      : id(_id), executionTime(_executionTime), relDeadline(_relDeadline),
+	uc(_uc) {}
+
+    ~TaskSpec() { delete uc; }
+
+    const unsigned int id; ///< task id
+    const TmsTimeInterval executionTime; ///< execution time
+    const TmsTimeInterval relDeadline; ///< relative critical time
+    UtilityCalculator* const uc; ///< the task's UtilityCalculator
+
+  private:
+    TaskSpec(const TaskSpec&);
+    TaskSpec& operator=(const TaskSpec&);
+  };
+
+  /// Shared, reference-counted task parameters
+  typedef std::shared_ptr<const TaskSpec> TaskSpecPtr;
+
+
+  /**
+   * @brief Execution state of one Task
+   *
+   * The state is reset in place by Task::start, so a task can be
+   * simulated again without reallocating it. The execution counters
+   * are kept in a TaskStatsTable.
+   */
+  struct TaskState {
+    TaskState() { reset(-1); }
+
+    /**
+     * @brief Clear the state, #delayCounters keeps its memory
+     * @param _nextActivation first activation time
+     */
+    void reset(TmsTime _nextActivation) {
+      nextActivation = _nextActivation;
+      lastValue = 1;
+      delayCounter = 0;
+      delayCounters.clear();
+    }
+
+    TmsTime nextActivation; ///< when will the next job be generated?
+    double lastValue; ///< utility of last job execution
+    size_t delayCounter; ///< counts current successive delays/cancellations
+    std::vector<int> delayCounters;
+  };
+
+} // NS tmssim
+
+#endif // !CORE_TASKSPEC_H
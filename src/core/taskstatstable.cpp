@@ -0,0 +1,79 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file taskstatstable.cpp
+ * @brief Execution statistics of all tasks of a simulation
+ */
+
+#include <core/taskstatstable.h>
+#include <core/steadystate.h>
+
+#include <cassert>
+
+namespace tmssim {
+
+  TaskStatsTable::TaskStatsTable(size_t n) {
+    resize(n);
+  }
+
+
+  void TaskStatsTable::resize(size_t n) {
+    activations.resize(n, 0);
+    completions.resize(n, 0);
+    cancellations.resize(n, 0);
+    misses.resize(n, 0);
+    preemptions.resize(n, 0);
+    execCancellations.resize(n, 0);
+    ecPerformanceLost.resize(n, 0);
+    usum.resize(n, 0);
+    esum.resize(n, 0);
+  }
+
+
+  void TaskStatsTable::reset(size_t slot) {
+    assert(slot < size());
+    activations[slot] = 0;
+    completions[slot] = 0;
+    cancellations[slot] = 0;
+    misses[slot] = 0;
+    preemptions[slot] = 0;
+    execCancellations[slot] = 0;
+    ecPerformanceLost[slot] = 0;
+    usum[slot] = 0;
+    esum[slot] = 0;
+  }
+
+
+  void TaskStatsTable::visitCounters(CounterVisitor& visitor) {
+    for (size_t i = 0; i < size(); ++i) {
+      visitor.visit(activations[i]);
+      visitor.visit(completions[i]);
+      visitor.visit(cancellations[i]);
+      visitor.visit(misses[i]);
+      visitor.visit(preemptions[i]);
+      visitor.visit(execCancellations[i]);
+      visitor.visit(ecPerformanceLost[i]);
+      visitor.visit(usum[i]);
+      visitor.visit(esum[i]);
+    }
+  }
+
+} // NS tmssim
@@ -0,0 +1,101 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file taskstatstable.h
+ * @brief Execution statistics of all tasks of a simulation
+ */
+
+#ifndef CORE_TASKSTATSTABLE_H
+#define CORE_TASKSTATSTABLE_H 1
+
+#include <core/primitives.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tmssim {
+
+  class CounterVisitor;
+
+  /**
+   * @brief Execution statistics of a set of tasks, one column per counter
+   *
+   * Each task of a Simulation records its statistics in one slot (the
+   * index of the task in the task set) of the simulation's table. The
+   * totals of a simulation are sums over contiguous columns, which do
+   * not need to visit the task objects.
+   *
+   * The utility columns mirror the task's UtilityAggregator, they are
+   * updated by the task after each job.
+   */
+  struct TaskStatsTable {
+    /**
+     * @param n number of slots
+     */
+    TaskStatsTable(size_t n = 0);
+
+    size_t size() const { return activations.size(); }
+
+    /**
+     * @brief Change the number of slots, new slots are cleared
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief Clear the counters of one slot
+     */
+    void reset(size_t slot);
+
+    /**
+     * @brief Visit all counters of all slots
+     */
+    void visitCounters(CounterVisitor& visitor);
+
+    /**
+     * @return the sum of a column
+     */
+    template<typename T>
+    static T sum(const std::vector<T>& column) {
+      T s = 0;
+      for (size_t i = 0; i < column.size(); ++i) {
+	s += column[i];
+      }
+      return s;
+    }
+
+    std::vector<int> activations;
+    std::vector<int> completions;
+    std::vector<int> cancellations;
+    std::vector<int> misses;
+    std::vector<int> preemptions;
+    /// cancellations after the job started execution
+    std::vector<int> execCancellations;
+    /// cycles lost due to exec cancellations
+    std::vector<TmsTime> ecPerformanceLost;
+    /// total utility of the task's UtilityAggregator
+    std::vector<double> usum;
+    /// number of utility values in the task's UtilityAggregator
+    std::vector<int> esum;
+  };
+
+} // NS tmssim
+
+#endif // !CORE_TASKSTATSTABLE_H
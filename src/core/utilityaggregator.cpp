@@ -29,6 +29,7 @@
  */
 
 #include <core/utilityaggregator.h>
+#include <core/steadystate.h>
 //#include <core/scobjects.h>
 
 #include <cmath>
@@ -73,6 +74,17 @@ namespace tmssim {
   }
   
   
+  bool UtilityAggregator::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
+
+
+  void UtilityAggregator::visitCounters(CounterVisitor& visitor) {
+    visitor.visit(utilitySum);
+    visitor.visit(utilityCount);
+  }
+
+
   std::ostream& operator << (std::ostream& ost, const UtilityAggregator& ua) {
     ost << "[" << ua.utilitySum << "/" << ua.utilityCount 
 	<< "=" << ua.getMeanUtility() << "]";
@@ -33,6 +33,9 @@
 
 namespace tmssim {
 
+  class CounterVisitor;
+  class StateSnapshot;
+
   /**
    * @brief History-cognisant utility function.
    *
@@ -109,6 +112,21 @@ namespace tmssim {
      *
      */
     virtual UtilityAggregator* clone() const = 0;
+
+    /**
+     * @brief Write the state of the HCUF for steady-state detection.
+     *
+     * The default implementation returns false, which disables
+     * steady-state detection. Override it in subclasses that keep a
+     * history of utility values.
+     * @return true if the complete state was written
+     */
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
+    /**
+     * @brief Visit the utility sum and count
+     */
+    void visitCounters(CounterVisitor& visitor);
     
     /**
      *
@@ -34,9 +34,12 @@
 #include <utils/bitstrings.h>
 #include <utils/logger.h>
 #include <utils/mtrunner.h>
+#include <utils/shardcoordinator.h>
 #include <utils/tlogger.h>
 #include <utils/kvfile.h>
+#include <utils/tmsexception.h>
 
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -45,6 +48,7 @@
 #include <mkeval/abstractmktaskset.h>
 #include <mkeval/mkeval.h>
 #include <mkeval/gstsimulation.h>
+#include <mkeval/mkbreakdownsearch.h>
 
 #include <mkeval/periodgenerator.h>
 #include <mkeval/intervalperiodgenerator.h>
@@ -90,10 +94,22 @@ AbstractMkTaskset* generateTaskset();
 BdResultSet* executeTaskset(AbstractMkTaskset* ats);
 /// Actual simulation
 BdResultSet* simulate(AbstractMkTaskset* ats);
+/// Actual simulation, bisection search
+BdResultSet* bisect(AbstractMkTaskset* ats);
 /// Result output
 void processResult(BdResultSet* rs);
 /// @}
 
+/// @name Sharding
+/// @{
+/// Fork the shards and merge their results
+bool runShards();
+/// Merge a result from a shard
+void processShardRecord(const string& record);
+string toRecord(const BdResultSet* rs);
+BdResultSet* fromRecord(const string& record);
+/// @}
+
 
 /// @name Program options
 /// @todo remove simple copies
@@ -129,8 +145,12 @@ vector<string> poAllocators;
 string theLogPrefix;
 /// @brief write TS to file?
 bool theToFile = false;
+/// @brief bisect instead of linear search
+bool theBisect = false;
 /// @brief TS prefix
 string theXmlPrefix = "";
+/// @brief number of worker processes
+unsigned theNShards;
 /// @}
 
 
@@ -162,6 +182,10 @@ MtRunner<AbstractMkTaskset,BdResultSet>* theSimulation;
 
 ofstream *resultLog;
 
+ShardCoordinator* theShards = NULL;
+/// index of this worker process, -1 in the coordinator or without shards
+int theShard = -1;
+
 /// @}
 
 
@@ -222,12 +246,18 @@ int main(int argc, char* argv[]) {
   }
   cout << endl;
 
-  theSimulation = new MtRunner<AbstractMkTaskset,BdResultSet>(generateTaskset, executeTaskset, processResult, theNThreads);
-  theSimulation->run();
+  bool shardsOk = true;
+  if (theNShards > 1) {
+    shardsOk = runShards();
+  }
+  else {
+    theSimulation = new MtRunner<AbstractMkTaskset,BdResultSet>(generateTaskset, executeTaskset, processResult, theNThreads);
+    theSimulation->run();
+  }
   
   cleanup();
 
-  return 0;
+  return shardsOk ? 0 : -1;
 }
 
 
@@ -253,6 +283,8 @@ void initialiseProgramOptions() {
     (",x", po::value<string>(&theXmlPrefix)->implicit_value(""), "Write successful tasksets to xml file (default prefix is log prefix")
     (",l", po::value<vector<string>>(&poLog), "Activate execution logs, for valid options see below")
     ("restrict-periods", "Use period generator by Goossens & Macq (periods with many common divisors")
+    ("bisect", "Bisect for the breakdown utilisation instead of a linear search (assumes monotonic schedulability)")
+    ("shards", po::value<unsigned>(&theNShards)->default_value(1), "Worker processes, each simulates a disjoint part of the seeds with -m threads")
     ;
 }
 
@@ -353,6 +385,10 @@ bool initialise() {
       theXmlPrefix = theLogPrefix;
     }
   }
+
+  if (vm.count("bisect")) {
+    theBisect = true;
+  }
   
   // allocators
   for (const string& alloc: poAllocators) {
@@ -397,7 +433,10 @@ bool initialise() {
     }
     *resultLog << " { max }";
     *resultLog << endl;
-    *resultLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]" << endl;
+    *resultLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]";
+    if (theBisect)
+      *resultLog << " (bisect: monotonic schedulability assumed)";
+    *resultLog << endl;
   }
   
  initialise_end:
@@ -412,6 +451,7 @@ void cleanup() {
   resultLog->close();
   delete resultLog;
   delete theSimulation;
+  delete theShards;
   delete thePeriodGenerator;  
 }
 
@@ -441,7 +481,7 @@ AbstractMkTaskset* generateTaskset() {
 
 
 BdResultSet* executeTaskset(AbstractMkTaskset* ats) {
-  BdResultSet* rs = simulate(ats);
+  BdResultSet* rs = theBisect ? bisect(ats) : simulate(ats);
   delete ats;
   return rs;
 }
@@ -572,7 +612,95 @@ BdResultSet* simulate(AbstractMkTaskset* ats) {
 }
 
 
+BdResultSet* bisect(AbstractMkTaskset* ats) {
+  BdResultSet* rs = new BdResultSet(ats->getSeed(), nEvals);
+
+  ostringstream oss;
+  oss << theLogPrefix << "-ts-" << ats->getSeed() << ".log";
+  ofstream simLog(oss.str(), ios::out | ios::trunc);
+
+  simLog << "Hyperperiod: " << ats->getHyperPeriod() << endl;
+  simLog << "FeasibilityMultiplicator: " << ats->getMkFeasibilityMultiplicator() << endl;
+
+  for (const MkEvalAllocatorPair* ap: theAllocators) {
+    // like the linear search, which stops at the first failure, do not
+    // look above the breakdown
+    MkBreakdownSearch bs(ats, theGenUtilisation, theUtilisationStep, ap, scc,
+			 MkBreakdownSearch::C_NONE);
+    bs.search();
+
+    for (const MkBreakdownSearch::Probe& p: bs.getProbes()) {
+      const MkTaskset* mkts = p.mkTaskset;
+      simLog << endl;
+      simLog << "Utilisation: " << mkts->targetUtilisation
+	     << " U_r: " << mkts->realUtilisation
+	     << " U_mk: " << mkts->mkUtilisation
+	     << endl;
+      simLog << p.simulation->getSimulationMessage() << endl;
+
+      const list<MkTask*>& tasks = p.simulation->getMkTasks();
+      GstSimulation* mkets = dynamic_cast<GstSimulation*>(p.simulation);
+      if (mkets != NULL) {
+	simLog << "\t";
+	const CompressedMkState* states = mkets->getLastMkStates();
+	size_t i = 0;
+	for (MkTask* task: tasks) {
+	  simLog << " ";
+	  printBitString(simLog, states[i], task->getK());
+	  ++i;
+	}
+	simLog << endl;
+      }
+
+      if (p.simulation->getSuccess() && theToFile) {
+	ostringstream oss;
+	oss << theXmlPrefix << "-" << mkts->targetUtilisation << "-" << ats->getSeed() << "-" << ap->id << ".xml";
+
+	vector<Task*> wtasks;
+	for (MkTask* t: tasks) {
+	  wtasks.push_back(new MkTask(t));
+	}
+
+	TasksetWriter* tsw = TasksetWriter::getInstance();
+	bool result = tsw->write(oss.str(), wtasks);
+	if (!result) {
+	  tError() << "Writing task set failed!";
+	}
+	for (Task* t: wtasks) {
+	  delete t;
+	}
+	wtasks.clear();
+      }
+    }
+
+    simLog << endl;
+    string map = bs.getMapStr();
+    simLog << ap->id << ": " << map;
+    if (map.find(MkBreakdownSearch::R_UNKNOWN) != string::npos)
+      simLog << " (monotonic schedulability assumed)";
+    simLog << endl;
+
+    BdResultData& rd = rs->data[allocatorIdMap.at(ap->id)];
+    const MkBreakdownSearch::Probe* bd = bs.getBreakdown();
+    if (bd != NULL) {
+      rd.breakdownUtilisation = bd->mkTaskset->targetUtilisation;
+      rd.realUtilisation = bd->mkTaskset->realUtilisation;
+      rd.mkUtilisation = bd->mkTaskset->mkUtilisation;
+      rd.success = true;
+    }
+  }
+
+  return rs;
+}
+
+
 void processResult(BdResultSet* rs) {
+  if (theShard >= 0) {
+    theShards->send(toRecord(rs));
+    delete rs;
+    return;
+  }
+
   double umax = 0;
   list<string> maxList;
   *resultLog << rs->seed << " ;";
@@ -601,3 +729,81 @@ void processResult(BdResultSet* rs) {
 }
 
 
+bool runShards() {
+  // no thread may exist when the shards are forked
+  cout.flush();
+  resultLog->flush();
+
+  theShards = new ShardCoordinator(theNShards);
+  try {
+    theShard = theShards->fork();
+  }
+  catch (TMSException& e) {
+    tError() << e.getMessage();
+    return false;
+  }
+
+  if (theShard >= 0) {
+    // every shard takes every theNShards-th seed
+    list<unsigned int> seeds;
+    size_t i = 0;
+    for (unsigned int seed: theSeeds) {
+      if (i % theNShards == (unsigned)theShard)
+	seeds.push_back(seed);
+      ++i;
+    }
+    theSeeds.swap(seeds);
+    theSimulation = new MtRunner<AbstractMkTaskset,BdResultSet>(generateTaskset, executeTaskset, processResult, theNThreads);
+    theSimulation->run();
+    theShards->finishWorker();
+  }
+
+  cout << "==INFO== Started " << theNShards << " shards" << endl;
+  unsigned failed = theShards->collect(processShardRecord);
+  if (failed > 0) {
+    tError() << failed << " shards failed, their unfinished seeds are missing.";
+  }
+  return failed == 0;
+}
+
+
+void processShardRecord(const string& record) {
+  BdResultSet* rs = fromRecord(record);
+  if (rs == NULL) {
+    tError() << "Invalid record from shard: " << record;
+    return;
+  }
+  processResult(rs);
+}
+
+
+string toRecord(const BdResultSet* rs) {
+  ostringstream oss;
+  oss << setprecision(17) << rs->seed;
+  for (size_t i = 0; i < nEvals; ++i) {
+    const BdResultData& d = rs->data[i];
+    oss << " " << d.breakdownUtilisation
+	<< " " << d.realUtilisation
+	<< " " << d.mkUtilisation
+	<< " " << d.success;
+  }
+  return oss.str();
+}
+
+
+BdResultSet* fromRecord(const string& record) {
+  istringstream iss(record);
+  unsigned seed;
+  if (!(iss >> seed))
+    return NULL;
+  BdResultSet* rs = new BdResultSet(seed, nEvals);
+  for (size_t i = 0; i < nEvals; ++i) {
+    BdResultData& d = rs->data[i];
+    if (!(iss >> d.breakdownUtilisation >> d.realUtilisation
+	  >> d.mkUtilisation >> d.success)) {
+      delete rs;
+      return NULL;
+    }
+  }
+  return rs;
+}
@@ -37,16 +37,22 @@
 #include <utils/logger.h>
 //#define TLOGLEVEL TLL_WARN
 #include <utils/tlogger.h>
+#include <utils/journal.h>
 #include <utils/kvfile.h>
 #include <utils/mtrunner.h>
+#include <utils/shardcoordinator.h>
+#include <utils/tmsexception.h>
 
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <list>
 #include <fstream>
+#include <map>
+#include <sstream>
 
 #include <condition_variable>
 #include <mutex>
@@ -102,6 +108,20 @@ MkEval* executeTaskset(MkTaskset* ats);
 /// Result output
 void processResult(MkEval* rs);
 
+/// Results of one task set
+struct TasksetResult;
+/// Add the results of one task set to the global results and logs
+void aggregateResult(const TasksetResult& tr);
+/// Parameters that must not change when resuming
+string journalHeader();
+string toJournalRecord(const TasksetResult& tr);
+bool fromJournalRecord(const string& record, TasksetResult& tr);
+
+/// Fork the shards and merge their results
+bool runShards();
+/// Merge a result from a shard
+void processShardRecord(const string& record);
+
 MtRunner<MkTaskset,MkEval>* theSimulation;
 
 /// @}
@@ -147,6 +167,10 @@ vector<string> poLog;
 bool theToFile = false;
 /// @brief TS prefix
 string theXmlPrefix = "";
+/// @brief continue from the journal of an interrupted run
+bool theResume = false;
+/// @brief number of worker processes
+unsigned theNShards;
 /// @}
 
 
@@ -177,6 +201,15 @@ ofstream** tsLogs;
 /// @brief logfile task success maps
 ofstream* taskSuccessLog;
 
+/// @brief journal of finished task sets
+Journal* theJournal = NULL;
+/// @brief seeds of task sets that are already in the journal
+map<unsigned int, unsigned int> finishedSeeds;
+
+ShardCoordinator* theShards = NULL;
+/// @brief index of this worker process, -1 in the coordinator or without shards
+int theShard = -1;
+
 /// @}
 
 
@@ -213,6 +246,16 @@ unsigned* resultSchedBucket = NULL;
 /// @brief Collect statistics about the task sets' utilisation
 UtilisationStatistics uStats;
 
+/// Results of one task set, also used for the journal
+struct TasksetResult {
+  unsigned int seed;
+  /// all simulations have finished, otherwise the task set is discarded
+  bool complete;
+  bool suffMKSched;
+  double realUtilisation;
+  vector<MKSimulationResults> results;
+};
+
 /// @}
 
 int main(int argc, char* argv[]) {
@@ -269,8 +312,14 @@ int main(int argc, char* argv[]) {
   cout << "==INFO== \tmaxWC: " << gcfg->getUInt32("maxWC") << endl << endl;
 
   // RUN
-  theSimulation = new MtRunner<MkTaskset,MkEval>(generateTaskset, executeTaskset, processResult, theNThreads);
-  theSimulation->run();
+  bool shardsOk = true;
+  if (theNShards > 1) {
+    shardsOk = runShards();
+  }
+  else {
+    theSimulation = new MtRunner<MkTaskset,MkEval>(generateTaskset, executeTaskset, processResult, theNThreads);
+    theSimulation->run();
+  }
 
 
   // FINISH
@@ -279,7 +328,53 @@ int main(int argc, char* argv[]) {
   printResults();
 
   cleanup();
-  return 0;
+  return shardsOk ? 0 : -1;
+}
+
+
+bool runShards() {
+  // no thread may exist when the shards are forked
+  cout.flush();
+  for (unsigned i = 0; i < nEvals; ++i) {
+    tsLogs[i]->flush();
+  }
+  taskSuccessLog->flush();
+  theJournal->sync();
+
+  theShards = new ShardCoordinator(theNShards);
+  try {
+    theShard = theShards->fork();
+  }
+  catch (TMSException& e) {
+    tError() << e.getMessage();
+    return false;
+  }
+
+  if (theShard >= 0) {
+    // generateTaskset selects the task sets of this shard
+    theSimulation = new MtRunner<MkTaskset,MkEval>(generateTaskset, executeTaskset, processResult, theNThreads);
+    theSimulation->run();
+    theShards->finishWorker();
+  }
+
+  cout << "==INFO== Started " << theNShards << " shards" << endl;
+  unsigned failed = theShards->collect(processShardRecord);
+  if (failed > 0) {
+    tError() << failed << " shards failed, their unfinished task sets are missing."
+	     << " Use --resume to simulate them.";
+  }
+  return failed == 0;
+}
+
+
+void processShardRecord(const string& record) {
+  TasksetResult tr;
+  if (!fromJournalRecord(record, tr)) {
+    tError() << "Invalid record from shard: " << record;
+    return;
+  }
+  aggregateResult(tr);
+  theJournal->append(record);
 }
 
 
@@ -287,6 +382,9 @@ void cleanup() {
   delete econf;
   delete gcfg;
 
+  delete theJournal;
+  delete theShards;
+
   if (vm.count("prefix")) { // flush and close log files
     for (unsigned i= 0; i < nEvals; ++i) {
       tsLogs[i]->close();
@@ -325,6 +423,9 @@ void initialiseProgramOptions() {
     ("prefix,p", po::value<string>(&theLogPrefix)->required(), "Log prefix")
     (",x", po::value<string>(&theXmlPrefix)->implicit_value(""), "Write successful tasksets to xml file (default prefix is log prefix")
     (",l", po::value<vector<string>>(&poLog), "Activate execution logs, for valid options see below")
+    ("event-driven,E", "Skip simulation steps without events (faster, condensed EXEC log)")
+    ("shards", po::value<unsigned>(&theNShards)->default_value(1), "Worker processes, each simulates a disjoint part of the task sets with -m threads")
+    ("resume", "Resume an interrupted run from its journal (<prefix>-journal.log), requires the same seed")
     ;
 }
 
@@ -353,6 +454,11 @@ bool initialise() {
     INITIALISE_FAIL;
   }
 
+  // time advance
+  if (vm.count("event-driven")) {
+    Simulation::setDefaultAdvanceMode(Simulation::AM_EVENT);
+  }
+
   // econf
   if (vm.count("econf")) {
     try {
@@ -440,6 +546,43 @@ bool initialise() {
   }
   cout << "Log class: " << hex << logger::getCurrentClass() << dec << endl;
 
+  // journal, replay finished task sets before any new results arrive
+  if (vm.count("resume")) {
+    theResume = true;
+  }
+  {
+    ostringstream oss;
+    oss << theLogPrefix << "-journal.log";
+    try {
+      theJournal = new Journal(oss.str(), theResume);
+    }
+    catch (TMSException& e) {
+      tError() << e.getMessage();
+      INITIALISE_FAIL;
+    }
+    const vector<string>& records = theJournal->getRecords();
+    if (records.empty()) {
+      theJournal->append(journalHeader());
+    }
+    else if (records.front() != journalHeader()) {
+      tError() << "Journal " << oss.str() << " was written with different parameters";
+      INITIALISE_FAIL;
+    }
+    else {
+      for (size_t i = 1; i < records.size(); ++i) {
+	TasksetResult tr;
+	if (!fromJournalRecord(records[i], tr)) {
+	  tError() << "Invalid record " << i << " in journal " << oss.str();
+	  INITIALISE_FAIL;
+	}
+	aggregateResult(tr);
+	++finishedSeeds[tr.seed];
+      }
+      cout << "==INFO== Resuming: " << (records.size() - 1)
+	   << " task sets finished" << endl;
+    }
+  }
+
 
  initialise_end:
   return success;
@@ -489,10 +632,26 @@ MkTaskset* generateTaskset() {
 			       gcfg->getUInt32("maxWC"));
   static unsigned genCtr = 0;
 
-  ++genCtr;
-  if (genCtr <= theNTasksets) {
+  while (++genCtr <= theNTasksets) {
     MkTaskset* mkts = generator.nextTaskset();
 
+    // all shards generate the same sequence, each takes every
+    // theNShards-th task set
+    if (theShard >= 0 && (genCtr - 1) % theNShards != (unsigned)theShard) {
+      delete mkts;
+      continue;
+    }
+
+    // skip task sets that are already in the journal
+    map<unsigned int, unsigned int>::iterator it = finishedSeeds.find(mkts->seed);
+    if (it != finishedSeeds.end()) {
+      if (--it->second == 0) {
+	finishedSeeds.erase(it);
+      }
+      delete mkts;
+      continue;
+    }
+
     if (theToFile) {
       ostringstream oss;
       oss << theXmlPrefix << "-" << mkts->seed << ".xml";
@@ -516,8 +675,7 @@ MkTaskset* generateTaskset() {
     
     return mkts;
   }
-  else
-    return 0;
+  return 0;
 }
 
 
@@ -532,12 +690,36 @@ void processResult(MkEval* eval) {
   if (eval == NULL) {
     return;
   }
-  if (eval->getSuccessMap() == EVAL_MAP_FULL(nEvals) ) {
+  TasksetResult tr;
+  tr.seed = eval->getTaskset()->seed;
+  tr.complete = eval->getSuccessMap() == EVAL_MAP_FULL(nEvals);
+  tr.suffMKSched = eval->getTaskset()->suffMKSched;
+  tr.realUtilisation = eval->getTaskset()->realUtilisation;
+  if (tr.complete) {
+    tr.results.assign(eval->getResults(), eval->getResults() + nEvals);
+  }
+  else {
+    // This should not happen, any scheduler should run until the end!
+    tError() << "Aggregator detected unfinished taskset!";
+  }
+  if (theShard >= 0) {
+    theShards->send(toJournalRecord(tr));
+  }
+  else {
+    aggregateResult(tr);
+    theJournal->append(toJournalRecord(tr));
+  }
+  delete eval;
+}
+
+
+void aggregateResult(const TasksetResult& tr) {
+  if (tr.complete) {
     // all schedulers successful
     unsigned int rb = 0;
     unsigned int rsb = 0;
     for (unsigned int i = 0; i < nEvals; ++i) {
-      const MKSimulationResults& sres = eval->getResults()[i];
+      const MKSimulationResults& sres = tr.results[i];
       results[i].successes += sres.success ? 1 : 0;
       results[i].activations += sres.activations;
       results[i].completions += sres.completions;
@@ -555,7 +737,7 @@ void processResult(MkEval* eval) {
 	rb |= 1 << i;
       }
       if (vm.count("prefix")) {
-	*tsLogs[i] << eval->getTaskset()->seed << " ; "
+	*tsLogs[i] << tr.seed << " ; "
 		   << sres.success << " ; "
 		   << sres.activations << " ; "
 		   << sres.completions << " ; "
@@ -573,7 +755,7 @@ void processResult(MkEval* eval) {
     // aggregate fully successfull tasksets
     if (rb == EVAL_MAP_FULL(nEvals)) {
       for (unsigned int i = 0; i < nEvals; ++i) {
-	const MKSimulationResults& sres = eval->getResults()[i];
+	const MKSimulationResults& sres = tr.results[i];
 	successResults[i].successes += sres.success ? 1 : 0;
 	successResults[i].activations += sres.activations;
 	successResults[i].completions += sres.completions;
@@ -593,26 +775,87 @@ void processResult(MkEval* eval) {
       }
     }
     
-    if (eval->getTaskset()->suffMKSched) {
+    if (tr.suffMKSched) {
       ++schedTestPass;
       rsb = 1 << nEvals;
     }
-    uStats.addUtilisation(eval->getTaskset()->realUtilisation);
+    uStats.addUtilisation(tr.realUtilisation);
     rsb |= rb;
     ++resultBucket[rb];
     ++resultSchedBucket[rsb];
     
     if (vm.count("prefix")) {
-      *taskSuccessLog << eval->getTaskset()->seed << " ; "
+      *taskSuccessLog << tr.seed << " ; "
 		      << binString(rsb, nEvals + 1) << endl;
     }
   }
   else {
-    // This should not happen, any scheduler should run until the end!
-    tError() << "Aggregator detected unfinished taskset!";
     ++discardedTasksets;
   }
-  delete eval;
+}
+
+
+string journalHeader() {
+  ostringstream oss;
+  oss << setprecision(17) << "mkeval"
+      << " s=" << theSeed
+      << " t=" << theTasksetSize
+      << " n=" << theSimulationSteps
+      << " T=" << theNTasksets
+      << " u=" << theUtilisation
+      << " d=" << theUtilisationDeviation
+      << " E=" << vm.count("event-driven")
+      << " a=";
+  for (const MkEvalAllocatorPair* ap: theAllocators) {
+    oss << ap->id << ",";
+  }
+  return oss.str();
+}
+
+
+string toJournalRecord(const TasksetResult& tr) {
+  ostringstream oss;
+  oss << setprecision(17)
+      << tr.seed << " " << tr.complete << " " << tr.suffMKSched
+      << " " << tr.realUtilisation;
+  for (const MKSimulationResults& sres: tr.results) {
+    oss << " " << sres.success
+	<< " " << sres.activations
+	<< " " << sres.completions
+	<< " " << sres.cancellations
+	<< " " << sres.execCancellations
+	<< " " << sres.misses
+	<< " " << sres.preemptions
+	<< " " << sres.usum
+	<< " " << sres.esum
+	<< " " << sres.mkfail;
+  }
+  return oss.str();
+}
+
+
+bool fromJournalRecord(const string& record, TasksetResult& tr) {
+  istringstream iss(record);
+  if (!(iss >> tr.seed >> tr.complete >> tr.suffMKSched >> tr.realUtilisation)) {
+    return false;
+  }
+  if (tr.complete) {
+    tr.results.resize(nEvals);
+    for (MKSimulationResults& sres: tr.results) {
+      if (!(iss >> sres.success
+	    >> sres.activations
+	    >> sres.completions
+	    >> sres.cancellations
+	    >> sres.execCancellations
+	    >> sres.misses
+	    >> sres.preemptions
+	    >> sres.usum
+	    >> sres.esum
+	    >> sres.mkfail))
+	return false;
+    }
+  }
+  return true;
 }
 
 
@@ -40,11 +40,17 @@ using namespace std;
 
 namespace tmssim {
 
+  GstSimulation::StateDetection GstSimulation::defaultStateDetection = GstSimulation::SD_HASH;
+
+
   GstSimulation::GstSimulation(std::list<MkTask*> _mkTasks, Scheduler* _scheduler,
 			     std::string _allocId)
     : MkSimulation(_mkTasks, _scheduler, _allocId),
       //mkTasks(_mkTasks), scheduler(_scheduler), nTasks(_mkTasks.size()),
-      hpCount(0), recurringState(false), recurringReducedState(false),
+      hpCount(0), stateDetection(defaultStateDetection),
+      current(nTasks), reduced(nTasks), lastStates(nTasks),
+      states(nTasks), recurringState(false), reducedStates(nTasks),
+      power(1), lambda(0), recurringReducedState(false),
       reducedStateHyperPeriod(0), reducedStateCycle(0), simulated(false),
       success(false)
   {
@@ -60,16 +66,6 @@ namespace tmssim {
 
 
   GstSimulation::~GstSimulation() {
-    for (CompressedMkState* cts: states) {
-      delete[] cts;
-    }
-    states.clear();
-
-    for (CompressedMkState* rts: reducedStates) {
-      delete[] rts;
-    }
-    reducedStates.clear();
-
     //delete simulation;
   }
 
@@ -92,13 +88,14 @@ namespace tmssim {
       }
       else {
 	// check current state
+	readStates();
 	if (checkState()) {
 	  // state recurred, so we're finished
 	  recurringState = true;
 	  finished = true;
 	}
 	// For eval of reduced state (only meaningful for MKU!)
-	if (checkReducedState() && !recurringReducedState) {
+	if (!recurringReducedState && checkReducedState()) {
 	  recurringReducedState = true;
 	  reducedStateHyperPeriod = hpCount;
 	  reducedStateCycle = simulation->getTime();
@@ -141,46 +138,52 @@ namespace tmssim {
   }
   
 
-  void GstSimulation::recordState() {
-    CompressedMkState* cts = new CompressedMkState[nTasks];
-    CompressedMkState* rts = new CompressedMkState[nTasks];
+  void GstSimulation::readStates() {
     size_t i = 0;
     for (MkTask* task: mkTasks) {
-      cts[i] = task->getMonitor().getState();
-      rts[i] = task->getMonitor().getReducedState();
+      current[i] = task->getMonitor().getState();
+      reduced[i] = task->getMonitor().getReducedState();
       ++i;
     }
-    states.push_back(cts);
-    reducedStates.push_back(rts);
   }
 
 
-  bool GstSimulation::checkState() const {
-    for (CompressedMkState* cts: states) {
-      bool cmp = true;
-      size_t i = 0;
-      for (MkTask* task: mkTasks) {
-	cmp &= cts[i] == task->getMonitor().getState();
-	++i;
-      }
-      if (cmp)
-	return true;
+  void GstSimulation::recordState() {
+    readStates();
+    lastStates = current;
+    if (stateDetection == SD_HASH) {
+      states.insert(current.data());
+      if (!recurringReducedState)
+	reducedStates.insert(reduced.data());
+    }
+    else if (hpCount == 0) {
+      tortoise = current;
+      power = 1;
+      lambda = 0;
+    }
+  }
+
+
+  bool GstSimulation::checkState() {
+    if (stateDetection == SD_HASH) {
+      return states.contains(current.data());
+    }
+    // Brent: compare with the state after the last power of two steps
+    ++lambda;
+    if (current == tortoise)
+      return true;
+    if (lambda == power) {
+      tortoise = current;
+      power *= 2;
+      lambda = 0;
     }
     return false;
   }
 
 
   bool GstSimulation::checkReducedState() {
-    for (CompressedMkState* rts: reducedStates) {
-      bool cmp = true;
-      size_t i = 0;
-      cmp = true;
-      for (MkTask* task: mkTasks) {
-	cmp &= rts[i] == task->getMonitor().getReducedState();
-	++i;
-      }
-      if (cmp)
-	return true;
+    if (stateDetection == SD_HASH) {
+      return reducedStates.contains(reduced.data());
     }
     return false;
   }
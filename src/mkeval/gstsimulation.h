@@ -29,11 +29,13 @@
 
 #include <cstdint>
 #include <list>
+#include <vector>
 
 #include <core/scheduler.h>
 #include <core/simulation.h>
 #include <taskmodels/mktask.h>
 #include <mkeval/mksimulation.h>
+#include <mkeval/mkstateset.h>
 
 namespace tmssim {
 
@@ -42,6 +44,19 @@ namespace tmssim {
    */
   class GstSimulation : public MkSimulation {
   public:
+    /**
+     * @brief How recurring (m,k)-states are detected
+     */
+    enum StateDetection {
+      SD_HASH, ///< remember all states at hyperperiod boundaries in a hash set
+      /**
+       * Brent's cycle detection: only remembers a single state, but may
+       * need more hyperperiods to find a recurrence. Reduced states are
+       * not checked in this mode.
+       */
+      SD_CYCLE
+    };
+
     GstSimulation(std::list<MkTask*> _mkTasks, Scheduler* _scheduler,
 		 std::string _allocId);
 
@@ -56,7 +71,8 @@ namespace tmssim {
 
     unsigned getHpCount() const { return hpCount; }
 
-    const CompressedMkState* getLastMkStates() const { return states.back(); }
+    /// (m,k)-states of all tasks at the begin of the last simulated hyperperiod
+    const CompressedMkState* getLastMkStates() const { return lastStates.data(); }
 
     TmsTime getHyperPeriod() const { return hyperPeriod; }
     TmsTime getMkFeasibilityMultiplicator() const { return mkFeasibilityMultiplicator; }
@@ -74,11 +90,19 @@ namespace tmssim {
     virtual std::string getInfoMessage();
     virtual std::string getSimulationMessage();
 
+    /**
+     * @brief Set the state detection of all subsequently created simulations.
+     * @param mode the detection mode, default is SD_HASH
+     */
+    static void setStateDetection(StateDetection mode) { defaultStateDetection = mode; }
+
   private:
 
     void initData();
+    /// store the current (m,k)-states of all tasks in #current and #reduced
+    void readStates();
     /// check whether the current (m,k)-state of all tasks has occurred before
-    bool checkState() const;
+    bool checkState();
     /// record the current (m,k)-state of all tasks
     void recordState();
 
@@ -99,15 +123,30 @@ namespace tmssim {
     //Simulation* simulation;
     unsigned hpCount;
 
-    /// size of each array is #nTasks
-    std::list<CompressedMkState*> states;
+    static StateDetection defaultStateDetection;
+    StateDetection stateDetection;
+
+    /// scratch buffers of size #nTasks
+    std::vector<CompressedMkState> current;
+    std::vector<CompressedMkState> reduced;
+    std::vector<CompressedMkState> lastStates;
+
+    /// (m,k)-states at all hyperperiod boundaries (SD_HASH only)
+    MkStateSet states;
     bool recurringState;
 
     /**
-     * Reduced  (m,k)-states (leave out least recent entry)
-     * size of each array is #nTasks
+     * Reduced  (m,k)-states (leave out least recent entry), only recorded
+     * until the first recurrence (SD_HASH only)
      */
-    std::list<CompressedMkState*> reducedStates;
+    MkStateSet reducedStates;
+
+    /// @name Brent's cycle detection (SD_CYCLE only)
+    /// @{
+    std::vector<CompressedMkState> tortoise;
+    unsigned power;
+    unsigned lambda;
+    /// @}
 
     bool recurringReducedState;
     TmsTime reducedStateHyperPeriod;
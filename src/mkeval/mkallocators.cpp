@@ -30,6 +30,8 @@
 
 #include <mkeval/mkallocators.h>
 
+#include <core/basicsimulation.h>
+
 #include <schedulers/schedulers.h>
 
 #include <taskmodels/mktask.h>
@@ -42,9 +44,21 @@
 namespace tmssim {
 
   MkAllocators* MkAllocators::_instance = NULL;
+
+
+  template<class SchedulerT, class TaskT>
+  static Simulation* BasicSimulationAllocator(Taskset* taskset, Scheduler* scheduler) {
+    if (!BasicSimulation<SchedulerT, TaskT>::matches(taskset, scheduler))
+      return NULL;
+    return new BasicSimulation<SchedulerT, TaskT>(taskset, scheduler);
+  }
+
   
 #define ADD_ALLOCATOR(_id, _schedAlloc, _taskAlloc, _simAlloc)			\
   allocators[_id] = MkEvalAllocatorPair((_id), (_schedAlloc), (_taskAlloc), (_simAlloc))
+
+#define ADD_SIMULATION(_schedulerT, _taskT)				\
+  simulationAllocators.push_back(BasicSimulationAllocator<_schedulerT, _taskT>)
   
   MkAllocators::MkAllocators() {
     ADD_ALLOCATOR("DBP", FPPSchedulerAllocator, DbpTaskAllocator, GstSimulationAllocator); // Hamdaoui & Ramanathan 1995
@@ -57,6 +71,15 @@ namespace tmssim {
     ADD_ALLOCATOR("MKU", MKUEDFSchedulerAllocator, MkTaskAllocator, GstSimulationAllocator); // Kluge et al.
     ADD_ALLOCATOR("DMU", DBPEDFSchedulerAllocator, MkTaskAllocator, GstSimulationAllocator); // com
     ADD_ALLOCATOR("GMUA-MK", GMUAMKSchedulerAllocator, MkTaskAllocator, GstSimulationAllocator); // Rhu et al. 2011
+
+    // scheduler/task combinations of the allocators above
+    ADD_SIMULATION(FPPScheduler, DbpTask);
+    ADD_SIMULATION(FPPScheduler, MkpTask);
+    ADD_SIMULATION(GDPAScheduler, MkTask);
+    ADD_SIMULATION(GDPASScheduler, MkTask);
+    ADD_SIMULATION(MKUEDFScheduler, MkTask);
+    ADD_SIMULATION(DBPEDFScheduler, MkTask);
+    ADD_SIMULATION(GMUAMKScheduler, MkTask);
   }
 
   
@@ -83,6 +106,16 @@ namespace tmssim {
   }
 
 
+  Simulation* MkAllocators::newSimulation(Taskset* taskset, Scheduler* scheduler) const {
+    for (SimulationAllocator sa: simulationAllocators) {
+      Simulation* simulation = sa(taskset, scheduler);
+      if (simulation != NULL)
+	return simulation;
+    }
+    return new Simulation(taskset, scheduler);
+  }
+
+
   list<string> MkAllocators::listAllocators() const {
     list<string> al;
     for (const pair<string, MkEvalAllocatorPair>& p: allocators) {
@@ -41,6 +41,9 @@ namespace tmssim {
   typedef MkSimulation* (*MkSimulationAllocator)(std::list<MkTask*> _mkTasks,
 						Scheduler* _scheduler,
 						const std::string& _allocId);
+  /// @return a simulation, or NULL if the types of scheduler/tasks do not fit
+  typedef Simulation* (*SimulationAllocator)(Taskset* _taskset,
+					     Scheduler* _scheduler);
   
   
   /**
@@ -83,6 +86,17 @@ namespace tmssim {
     static const MkAllocators& instance();
     const MkEvalAllocatorPair* getAllocatorPair(std::string allocatorId) const;
     std::list<std::string> listAllocators() const;
+
+    /**
+     * @brief Create the Simulation for a task set.
+     *
+     * For the combinations of scheduler and task model that are used by
+     * the allocators, this is a BasicSimulation with statically bound
+     * scheduler and task calls, else a Simulation.
+     * @param taskset the tasks (the simulation takes ownership)
+     * @param scheduler the scheduler (the simulation takes ownership)
+     */
+    Simulation* newSimulation(Taskset* taskset, Scheduler* scheduler) const;
     
   private:
     static MkAllocators* _instance;
@@ -107,6 +121,7 @@ namespace tmssim {
     
 
     std::map<std::string, MkEvalAllocatorPair> allocators;
+    std::list<SimulationAllocator> simulationAllocators;
   }; // class MkAllocators
 
 } // NS tmssim
@@ -0,0 +1,151 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file mkbreakdownsearch.cpp
+ * @brief Bisection search for the breakdown utilisation of a single
+ *        allocator
+ */
+
+#include <mkeval/mkbreakdownsearch.h>
+
+#include <cassert>
+
+using namespace std;
+
+namespace tmssim {
+
+  MkBreakdownSearch::MkBreakdownSearch(AbstractMkTaskset* _ats, double _u0,
+				       double _uStep,
+				       const MkEvalAllocatorPair* _allocator,
+				       const SchedulerConfiguration& _scc,
+				       Check _check)
+    : ats(_ats), u0(_u0), uStep(_uStep), allocator(_allocator), scc(_scc),
+      check(_check), breakdown(-1), lastSuccess(-1), anomaly(false)
+  {
+  }
+
+
+  MkBreakdownSearch::~MkBreakdownSearch() {
+    for (Probe& p: probes) {
+      delete p.simulation;
+      delete p.mkTaskset;
+    }
+  }
+
+
+  void MkBreakdownSearch::search() {
+    // same grid as MkDseSimulationSet, the utilisations are accumulated
+    // in the same way to get identical values
+    double u = u0;
+    ats->setUtilisation(u);
+    while (ats->getMkUtilisation() <= 1.0) {
+      utils.push_back(u);
+      u += uStep;
+      ats->setUtilisation(u);
+    }
+    results.assign(utils.size(), R_UNKNOWN);
+
+    // invariant: lo succeeds (or is below the grid), hi fails (or is
+    // above the grid, where U_mk > 1)
+    long lo = -1;
+    long hi = utils.size();
+    while (hi - lo > 1) {
+      long mid = lo + (hi - lo) / 2;
+      if (probe(mid))
+	lo = mid;
+      else
+	hi = mid;
+    }
+
+    // look for a success above the first failure, all points above hi
+    // that were simulated during bisection failed
+    if (check == C_PROBE) {
+      if (hi + 1 < (long)utils.size() && results[hi + 1] == R_UNKNOWN
+	  && probe(hi + 1))
+	anomaly = true;
+    }
+    else if (check == C_SCAN) {
+      for (size_t i = hi + 1; i < utils.size() && !anomaly; ++i) {
+	if (results[i] == R_UNKNOWN && probe(i))
+	  anomaly = true;
+      }
+    }
+    // schedulability is not monotonic for this task set, so the bracket
+    // cannot be trusted and the rest of the grid is simulated, too
+    if (anomaly && check == C_SCAN) {
+      for (size_t i = 0; i < utils.size(); ++i) {
+	if (results[i] == R_UNKNOWN)
+	  probe(i);
+      }
+    }
+
+    // last success before the first failure, unsimulated points are
+    // skipped
+    long first = -1;
+    for (size_t i = 0; i < results.size() && results[i] != R_FAIL; ++i) {
+      if (results[i] == R_SUCCESS)
+	first = i;
+    }
+    if (first >= 0) {
+      for (size_t i = 0; i < probes.size(); ++i) {
+	if ((long)probes[i].index == first)
+	  breakdown = i;
+      }
+    }
+  }
+
+
+  const MkBreakdownSearch::Probe* MkBreakdownSearch::getBreakdown() const {
+    return breakdown < 0 ? NULL : &probes[breakdown];
+  }
+
+
+  const MkBreakdownSearch::Probe* MkBreakdownSearch::getLastSuccess() const {
+    return lastSuccess < 0 ? NULL : &probes[lastSuccess];
+  }
+
+
+  string MkBreakdownSearch::getMapStr() const {
+    return string(results.begin(), results.end());
+  }
+
+
+  bool MkBreakdownSearch::probe(size_t i) {
+    assert(results[i] == R_UNKNOWN);
+    ats->setUtilisation(utils[i]);
+    Probe p;
+    p.index = i;
+    p.mkTaskset = ats->getMkTasks();
+    list<MkTask*> tasks;
+    for (MkTask* task: p.mkTaskset->tasks) {
+      tasks.push_back(allocator->taskAlloc(task));
+    }
+    p.simulation = allocator->simAlloc(tasks, allocator->schedAlloc(scc),
+				       allocator->id);
+    bool success = p.simulation->simulate();
+    probes.push_back(p);
+    results[i] = success ? R_SUCCESS : R_FAIL;
+    if (success && (lastSuccess < 0 || probes[lastSuccess].index < i))
+      lastSuccess = probes.size() - 1;
+    return success;
+  }
+
+} // NS tmssim
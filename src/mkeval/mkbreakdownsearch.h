@@ -0,0 +1,155 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file mkbreakdownsearch.h
+ * @brief Bisection search for the breakdown utilisation of a single
+ *        allocator
+ */
+
+#ifndef MKEVAL_MKBREAKDOWNSEARCH_H
+#define MKEVAL_MKBREAKDOWNSEARCH_H 1
+
+#include <mkeval/abstractmktaskset.h>
+#include <mkeval/mkallocators.h>
+#include <mkeval/mkglobals.h>
+#include <mkeval/mksimulation.h>
+
+#include <string>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Bisection search for the breakdown utilisation of an
+   * AbstractMkTaskset under a single allocator.
+   *
+   * The search uses the same utilisation grid as the linear search in
+   * MkDseSimulationSet: u0, u0+uStep, ... as long as the (m,k)-utilisation
+   * does not exceed 1. Assuming that schedulability is monotonic in the
+   * utilisation, the breakdown point is bracketed with O(log n)
+   * simulations instead of n. After bracketing, the grid above the first
+   * failure can be checked for non-monotonic behaviour, see #Check.
+   * Anomalies are only reported if such a check finds one.
+   */
+  class MkBreakdownSearch {
+  public:
+    /// Result of a single grid point
+    enum Result {
+      R_UNKNOWN = '-',
+      R_SUCCESS = '1',
+      R_FAIL = '0'
+    };
+
+    /// Check above the first failure after bracketing
+    enum Check {
+      /// no further simulation
+      C_NONE,
+      /// simulate the grid point above the first failure once more
+      C_PROBE,
+      /**
+       * simulate the grid points above the first failure up to the first
+       * success; if there is one, simulate the whole grid, so that the
+       * result is the same as that of the linear search. This is O(n)!
+       */
+      C_SCAN
+    };
+
+    /// A simulated grid point
+    struct Probe {
+      size_t index; ///< index in the utilisation grid
+      MkTaskset* mkTaskset;
+      MkSimulation* simulation;
+    };
+
+    /**
+     * @param _ats the task set; the search changes its utilisation, so
+     * it must not be used by others during search()
+     * @param _u0 start utilisation
+     * @param _uStep resolution of the search
+     * @param _check check for anomalies after bracketing
+     */
+    MkBreakdownSearch(AbstractMkTaskset* _ats, double _u0, double _uStep,
+		      const MkEvalAllocatorPair* _allocator,
+		      const SchedulerConfiguration& _scc,
+		      Check _check);
+
+    ~MkBreakdownSearch();
+
+    /**
+     * @brief Perform the search
+     */
+    void search();
+
+    AbstractMkTaskset* getAts() const { return ats; }
+    const MkEvalAllocatorPair* getAllocator() const { return allocator; }
+
+    /// number of grid points with (m,k)-utilisation <= 1
+    size_t getNUtils() const { return utils.size(); }
+
+    /// utilisation of grid point i
+    double getUtilisation(size_t i) const { return utils[i]; }
+
+    /**
+     * @return the highest grid point below the first failure, the
+     * simulation of this point is in the probe list; NULL if the task
+     * set fails already at u0
+     */
+    const Probe* getBreakdown() const;
+
+    /**
+     * @return the highest successfully simulated grid point; NULL if
+     * there is none
+     */
+    const Probe* getLastSuccess() const;
+
+    /// A monotonicity anomaly was observed
+    bool getAnomaly() const { return anomaly; }
+
+    /// All simulated grid points in the order of simulation
+    const std::vector<Probe>& getProbes() const { return probes; }
+
+    /// Result map in the style of Bitmap::str(), unsimulated points are '-'
+    std::string getMapStr() const;
+
+  private:
+    /// Simulate grid point i
+    bool probe(size_t i);
+
+    AbstractMkTaskset* ats;
+    double u0;
+    double uStep;
+    const MkEvalAllocatorPair* allocator;
+    const SchedulerConfiguration& scc;
+    Check check;
+
+    std::vector<double> utils;
+    std::vector<char> results;
+    std::vector<Probe> probes;
+    /// index into #probes of the breakdown point, or -1
+    int breakdown;
+    /// index into #probes of the highest success, or -1
+    int lastSuccess;
+    bool anomaly;
+  };
+
+} // NS tmssim
+
+#endif // !MKEVAL_MKBREAKDOWNSEARCH_H
@@ -33,6 +33,7 @@
 #include <mkeval/concretemktaskset.h>
 #include <mkeval/fixedtimesimulation.h>
 #include <mkeval/mkallocators.h>
+#include <mkeval/mkbreakdownsearch.h>
 #include <mkeval/mkdsesimulationset.h>
 #include <mkeval/gstsimulation.h>
 #include <mkeval/mkglobals.h>
@@ -43,13 +44,18 @@
 #include <mkeval/gmperiodgenerator.h>
 
 #include <utils/bitstrings.h>
+#include <utils/journal.h>
 #include <utils/mtlgrunner.h>
+#include <utils/shardcoordinator.h>
 #include <utils/tlogger.h>
+#include <utils/tmsexception.h>
 
 #include <xmlio/tasksetwriter.h>
 
+#include <algorithm>
 #include <bitset>
 #include <cstdint>
+#include <iomanip>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -94,8 +100,11 @@ bool checkGCfg(void);
 
 /**
  * Calculate number of utilisations and initialise #mapLog file
+ * @param seeds the seeds of all task sets; the maximum utilisation is
+ * determined independently of the task set generation, so results can
+ * be processed before all task sets are generated.
  */
-void finishInitialisation(void);
+void finishInitialisation(list<unsigned int> seeds);
 
 /// @name Simulation functions
 /// @{
@@ -111,9 +120,49 @@ void processResult(MkSimulation* mkSimulation);
 /// @}
 
 void writeDssLog(MkDseSimulationSet* dss);
-void writeDssToGlobalLogs(MkDseSimulationSet* dss);
 void cleanupDss(MkDseSimulationSet* dss);
 
+/// @name Bisection search functions
+/// @{
+struct SearchSet;
+/// Create one search per allocator for the next seed
+list<MkBreakdownSearch*> generateSearches();
+/// Search execution
+MkBreakdownSearch* executeSearch(size_t tid, MkBreakdownSearch* search);
+/// Result output
+void processSearch(MkBreakdownSearch* search);
+void writeSearchLog(SearchSet* ss);
+/// @}
+
+/// @name Global logs and journal
+/// @{
+struct SeedResult;
+void getDssResult(MkDseSimulationSet* dss, SeedResult& sr);
+void getSearchResult(SearchSet* ss, SeedResult& sr);
+/// Write the results of one seed to the global logs
+void writeToGlobalLogs(const SeedResult& sr);
+/// Parameters that must not change when resuming
+string journalHeader();
+string toJournalRecord(const SeedResult& sr);
+bool fromJournalRecord(const string& record, SeedResult& sr);
+/// Remove seeds with journaled results from theSeeds
+void skipFinishedSeeds();
+/// Write journaled results to the global logs
+void replayJournal();
+/// Hand the results of one seed to the global logs, or to the coordinator
+void commitResult(const SeedResult& sr);
+/// @}
+
+/// @name Sharding
+/// @{
+/// Run the simulations, either in this process or in a shard
+void runSimulations();
+/// Fork the shards and merge their results
+bool runShards(const list<unsigned int>& allSeeds);
+/// Merge a result from a shard
+void processShardRecord(const string& record);
+/// @}
+
 void signalHandler(int signo);
 
 
@@ -157,6 +206,16 @@ string theXmlPrefix = "";
 TmsTime theSteps = 0;
 /// @brief Period generator
 PeriodGenerator* thePeriodGenerator;
+/// @brief max. simulations generated but not yet processed
+unsigned theMaxInFlight;
+/// @brief bisect instead of simulating all utilisations
+bool theBisect = false;
+/// @brief check for anomalies after bisection
+MkBreakdownSearch::Check theBisectCheck = MkBreakdownSearch::C_PROBE;
+/// @brief continue from the journal of an interrupted run
+bool theResume = false;
+/// @brief number of worker processes
+unsigned theNShards;
 /// @}
 
 /// @name Actual parameters (only for those that need preprocessing)
@@ -175,17 +234,11 @@ map<string, size_t> allocatorIdMap;
 unsigned nEvals;
 list<unsigned int> theSeeds;
 
-list<MkSimulation*> allSimulations;
-
 bool initialisationFinished = false;
 std::mutex initLock;
 std::condition_variable initCond;
 thread tInit;
 
-bool generationFinished = false;
-std::mutex genLock;
-std::condition_variable genCond;
-
 unsigned nUtils;
 double uMax = 0.0;
 
@@ -200,6 +253,15 @@ MtLgRunner<MkSimulation,MkSimulation>* theSimulation;
 
 MkSimulation** currentSim;
 
+/// Bisection searches for all allocators of one seed
+struct SearchSet {
+  unsigned int genSeed; ///< seed from theSeeds
+  std::vector<MkBreakdownSearch*> searches;
+  size_t nFinished;
+};
+
+MtLgRunner<MkBreakdownSearch,MkBreakdownSearch>* theSearch = NULL;
+
 
 ofstream *bdfLog;
 ofstream *bdlLog;
@@ -213,9 +275,45 @@ ofstream *anLog; // anomalies
 list<MkDseSimulationSet*> simulationSets;
 map<ConcreteMkTaskset*, MkDseSimulationSet*> ctsToSs;
 map<MkSimulation*, ConcreteMkTaskset*> mkSimToCts;
+map<MkBreakdownSearch*, SearchSet*> searchToSs;
+/// seeds from theSeeds, the seed of the AbstractMkTaskset may differ
+map<MkDseSimulationSet*, unsigned int> dssToGenSeed;
+/// @}
+
+
+/// @name Journal
+/// @{
+
+/// Utilisations of one step of the utilisation grid
+struct UtilisationPoint {
+  double target;
+  double real;
+  double mk;
+};
+
+/// Results of all allocators for one seed
+struct SeedResult {
+  unsigned int genSeed; ///< seed from theSeeds
+  unsigned int seed; ///< seed of the AbstractMkTaskset
+  size_t nSims;
+  std::vector<UtilisationPoint> utils;
+  /// per allocator and utilisation: '1' success, '0' failure, '-' not simulated
+  std::vector<std::string> maps;
+};
+
+Journal* theJournal = NULL;
+/// results read from the journal
+list<SeedResult> replayResults;
 mutex mgtLock;
 /// @}
 
+/// @name Sharding
+/// @{
+ShardCoordinator* theShards = NULL;
+/// index of this worker process, -1 in the coordinator or without shards
+int theShard = -1;
+/// @}
+
 
 /// Final stats
 size_t nTasksets = 0;
@@ -294,12 +392,22 @@ int main(int argc, char* argv[]) {
     cerr << "Cannot register handler" << endl;
   }
 
-  tInit = thread(&finishInitialisation);  
-  
-  theSimulation = new MtLgRunner<MkSimulation,MkSimulation>(generateTaskset, executeTaskset, processResult, theNThreads);
-  theSimulation->run();
-
-  tInit.join();
+  bool shardsOk = true;
+  {
+    // finishInitialisation needs all seeds
+    list<unsigned int> allSeeds = theSeeds;
+    if (theResume) {
+      skipFinishedSeeds();
+    }
+    if (theNShards > 1) {
+      shardsOk = runShards(allSeeds);
+    }
+    else {
+      tInit = thread(&finishInitialisation, allSeeds);
+      runSimulations();
+      tInit.join();
+    }
+  }
 
   cout << "==INFO== " << "\tTotal concrete task sets: " << nSims << endl;
   cout << "==INFO== " << "\tUmax: " << uMax << " nUtils: " << nUtils << endl;
@@ -315,7 +423,76 @@ int main(int argc, char* argv[]) {
   
   cleanup();
   
-  return 0;
+  return shardsOk ? 0 : -1;
+}
+
+
+void runSimulations() {
+  if (theBisect) {
+    theSearch = new MtLgRunner<MkBreakdownSearch,MkBreakdownSearch>(generateSearches, executeSearch, processSearch, theNThreads, theMaxInFlight);
+    theSearch->run();
+  }
+  else {
+    theSimulation = new MtLgRunner<MkSimulation,MkSimulation>(generateTaskset, executeTaskset, processResult, theNThreads, theMaxInFlight);
+    theSimulation->run();
+  }
+}
+
+
+bool runShards(const list<unsigned int>& allSeeds) {
+  // No thread may exist when the shards are forked, and the shards
+  // inherit uMax/nUtils and the replayed journal
+  finishInitialisation(allSeeds);
+  cout.flush();
+  bdfLog->flush();
+  bdlLog->flush();
+  mapLog->flush();
+  anLog->flush();
+  theJournal->sync();
+
+  theShards = new ShardCoordinator(theNShards);
+  try {
+    theShard = theShards->fork();
+  }
+  catch (TMSException& e) {
+    tError() << e.getMessage();
+    return false;
+  }
+
+  if (theShard >= 0) {
+    // every shard takes every theNShards-th of the remaining seeds
+    list<unsigned int> seeds;
+    size_t i = 0;
+    for (unsigned int seed: theSeeds) {
+      if (i % theNShards == (unsigned)theShard)
+	seeds.push_back(seed);
+      ++i;
+    }
+    theSeeds.swap(seeds);
+    runSimulations();
+    theShards->finishWorker();
+  }
+
+  cout << "==INFO== " << "	Started " << theNShards << " shards" << endl;
+  unsigned failed = theShards->collect(processShardRecord);
+  if (failed > 0) {
+    tError() << failed << " shards failed, their unfinished seeds are missing."
+	     << " Use --resume to simulate them.";
+  }
+  return failed == 0;
+}
+
+
+void processShardRecord(const string& record) {
+  SeedResult sr;
+  if (!fromJournalRecord(record, sr)) {
+    tError() << "Invalid record from shard: " << record;
+    return;
+  }
+  writeToGlobalLogs(sr);
+  theJournal->append(record);
+  nSims += sr.nSims;
+  finishedSims += sr.nSims;
 }
 
 
@@ -333,11 +510,19 @@ void initialiseProgramOptions() {
     (",d", po::value<double>(&theUtilisationDeviation)->default_value(0.1), "Deviation of actual utilisation for minimum utilisation")
     (",n", po::value<TmsTime>(&theSteps)->default_value(0), "Number of steps to simulate (if 0, use exact schedulability tests)")
     (",m", po::value<unsigned>(&theNThreads)->default_value(thread::hardware_concurrency()), "Simulation threads")
+    ("in-flight", po::value<unsigned>(&theMaxInFlight), "Max. simulations generated but not yet finished [default=16 per thread, 0=unlimited]")
     (",a", po::value<vector<string>>(&poAllocators)->required(), "Scheduler/Task allocators, for valid options see below")
     ("prefix,p", po::value<string>(&theLogPrefix)->required(), "Log prefix")
     (",x", po::value<string>(&theXmlPrefix)->implicit_value(""), "Write successful tasksets to xml file (default prefix is log prefix")
     (",l", po::value<vector<string>>(&poLog), "Activate execution logs, for valid options see below")
     ("restrict-periods", "Use period generator by Goossens & Macq (periods with many common divisors")
+    ("event-driven,E", "Skip simulation steps without events (faster, condensed EXEC log)")
+    ("steady-state", "With -n: skip repetitions of a periodic steady state (same results)")
+    ("resume", "Resume an interrupted run from its journal (<prefix>-journal.log)")
+    ("shards", po::value<unsigned>(&theNShards)->default_value(1), "Worker processes, each simulates a disjoint part of the seeds with -m threads")
+    ("bisect", "Bisect for the breakdown utilisation of each allocator instead of simulating all utilisations (assumes monotonic schedulability)")
+    ("bisect-verify", "With --bisect: simulate all utilisations above the breakdown up to the first success, and all utilisations if there is one (finds more anomalies, but needs O(n) simulations)")
+    ("cycle-detection", "Detect recurring (m,k)-states with Brent's algorithm instead of storing all states (less memory, may simulate more hyperperiods)")
     ;
 }
 
@@ -395,6 +580,33 @@ bool initialise() {
     INITIALISE_FAIL;
   }
 
+  // time advance
+  if (vm.count("event-driven")) {
+    Simulation::setDefaultAdvanceMode(Simulation::AM_EVENT);
+  }
+  if (vm.count("steady-state")) {
+    Simulation::setDefaultSteadyStateDetection(true);
+  }
+
+  if (vm.count("bisect")) {
+    theBisect = true;
+  }
+  if (vm.count("bisect-verify")) {
+    if (!theBisect) {
+      tError() << "--bisect-verify requires --bisect";
+      INITIALISE_FAIL;
+    }
+    theBisectCheck = MkBreakdownSearch::C_SCAN;
+  }
+
+  if (vm.count("resume")) {
+    theResume = true;
+  }
+
+  if (vm.count("cycle-detection")) {
+    GstSimulation::setStateDetection(GstSimulation::SD_CYCLE);
+  }
+
   // econf
   if (vm.count("econf")) {
     try {
@@ -453,6 +665,10 @@ bool initialise() {
   if (theSteps != 0) {
     FixedTimeSimulation::setSteps(theSteps);
   }
+
+  if (!vm.count("in-flight")) {
+    theMaxInFlight = 16 * theNThreads;
+  }
   
   // allocators
   for (const string& alloc: poAllocators) {
@@ -498,7 +714,10 @@ bool initialise() {
     }
     *bdfLog << " { max }";
     *bdfLog << endl;
-    *bdfLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]" << endl;
+    *bdfLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]";
+    if (theBisect)
+      *bdfLog << " (bisect: monotonic schedulability assumed)";
+    *bdfLog << endl;
   }
 
   {
@@ -511,7 +730,10 @@ bool initialise() {
     }
     *bdlLog << " { max }";
     *bdlLog << endl;
-    *bdlLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]" << endl;
+    *bdlLog << "\t[sched] = [ u_breakdown ; u_real ; u_mk ]";
+    if (theBisect)
+      *bdlLog << " (bisect: monotonic schedulability assumed)";
+    *bdlLog << endl;
   }
 
   {// Map log
@@ -533,9 +755,41 @@ bool initialise() {
     for (const MkEvalAllocatorPair* ap: theAllocators) {
       *anLog << " [" << ap->id << "]";
     }
+    if (theBisect)
+      *anLog << " (bisect: only anomalies above the breakdown are detected)";
     *anLog << endl;
   }
 
+  {// Journal
+    ostringstream oss;
+    oss << theLogPrefix << "-journal.log";
+    try {
+      theJournal = new Journal(oss.str(), theResume);
+    }
+    catch (TMSException& e) {
+      tError() << e.getMessage();
+      INITIALISE_FAIL;
+    }
+    const vector<string>& records = theJournal->getRecords();
+    if (records.empty()) {
+      theJournal->append(journalHeader());
+    }
+    else if (records.front() != journalHeader()) {
+      tError() << "Journal " << oss.str() << " was written with different parameters";
+      INITIALISE_FAIL;
+    }
+    else {
+      for (size_t i = 1; i < records.size(); ++i) {
+	SeedResult sr;
+	if (!fromJournalRecord(records[i], sr)) {
+	  tError() << "Invalid record " << i << " in journal " << oss.str();
+	  INITIALISE_FAIL;
+	}
+	replayResults.push_back(sr);
+      }
+    }
+  }
+
   currentSim = new MkSimulation*[theNThreads];
   for (size_t i = 0; i < theNThreads; ++i) {
     currentSim[i] = NULL;
@@ -562,7 +816,10 @@ void cleanup() {
   delete mapLog;
   anLog->close();
   delete anLog;
+  delete theJournal;
   delete theSimulation;
+  delete theSearch;
+  delete theShards;
   delete[] nSuccesses;
   if (theSteps != 0) {
     for (const MkEvalAllocatorPair* ap: theAllocators) {
@@ -583,14 +840,21 @@ bool checkGCfg(void) {
 }
 
 
-void finishInitialisation(void) {
-  {
-    std::unique_lock<std::mutex> lck(genLock);
-    while (!generationFinished) {
-      genCond.wait(lck);
+void finishInitialisation(list<unsigned int> seeds) {
+  // same utilisations as in MkDseSimulationSet
+  for (unsigned int seed: seeds) {
+    AbstractMkTaskset ats(seed, theTasksetSize, gcfg,
+			  theUtilisationDeviation, theGenUtilisation,
+			  thePeriodGenerator);
+    double u = theGenUtilisation;
+    ats.setUtilisation(u);
+    while (ats.getMkUtilisation() <= 1.0) {
+      if (u > uMax)
+	uMax = u;
+      u += theUtilisationStep;
+      ats.setUtilisation(u);
     }
   }
-  //nSims = allSimulations.size();
 
   *mapLog << "Utilisations:";
   double util = theGenUtilisation;
@@ -601,6 +865,7 @@ void finishInitialisation(void) {
     ++nUtils;
   }
   *mapLog << endl;
+  replayJournal();
   {
     unique_lock<mutex> lck(initLock);
     initialisationFinished = true;
@@ -626,19 +891,14 @@ list<MkSimulation*> generateTaskset() {
     {
       std::unique_lock<std::mutex> lck(mgtLock);
       simulationSets.push_back(dss);
+      dssToGenSeed[dss] = cSeed;
       const std::vector<ConcreteMkTaskset*>& ctss = dss->getCtss();
       for(ConcreteMkTaskset* cts: ctss) {
 	ctsToSs[cts] = dss;
-	double uc = cts->getMkTaskset()->targetUtilisation;
-	if (uc > uMax) {
-	  //cout << "new umax: " << uc << endl;
-	  uMax = uc;
-	}
 	const vector<MkSimulation*>& mkss = cts->getMkSimulations();
 	for (MkSimulation* mksim: mkss) {
 	  mkSimToCts[mksim] = cts;
 	  mksims.push_back(mksim);
-	  allSimulations.push_back(mksim);
 	  ++nSims;
 	}
 	if (theToFile) {
@@ -650,12 +910,6 @@ list<MkSimulation*> generateTaskset() {
     }
   }
 
-  if (theSeeds.size() == 0) {
-    unique_lock<mutex> lck(genLock);
-    generationFinished = true;
-    genCond.notify_all();
-  }
-  
   return mksims;
 }
 
@@ -733,7 +987,9 @@ void processResult(MkSimulation* mkSimulation) {
     dss->notifyFinished(cts);
     if (dss->isFinished()) {
       writeDssLog(dss);
-      writeDssToGlobalLogs(dss);
+      SeedResult sr;
+      getDssResult(dss, sr);
+      commitResult(sr);
       cleanupDss(dss);
     }
   }
@@ -807,117 +1063,338 @@ void writeDssLog(MkDseSimulationSet* dss) {
 }
 
 
-void writeDssToGlobalLogs(MkDseSimulationSet* dss) {
+void signalHandler(int signo) {
+  std::unique_lock<std::mutex> lck(mgtLock);
+  if (signo != SIGUSR1) {
+    cerr << "Not configured to handle signal " << signo << endl;
+  }
+  for (size_t i = 0; i < theNThreads; ++i) {
+    cout << "T" << i << ": ";
+    MkSimulation* sim = currentSim[i];
+    if (sim == NULL) {
+      cout << "NULL" << endl;
+    }
+    else {
+      ConcreteMkTaskset* cts = mkSimToCts.at(sim);
+      MkDseSimulationSet* mss = ctsToSs.at(cts);
+      cout << mss->getAts()->getSeed() << "-" << sim->getAllocId()
+	   << "@" << cts->getMkTaskset()->targetUtilisation
+	   << " (C: " << sim->getSimulation()->getTime() << ")"
+	   << endl;
+    }
+  }
+  cout << "Finished: " << finishedSims << "/" << nSims << endl;
+  cout << endl;
+}
+
 
-  // @todo handling of "duplicates"
+void cleanupDss(MkDseSimulationSet* dss) {
   const std::vector<ConcreteMkTaskset*>& ctss = dss->getCtss();
-  size_t nCts = ctss.size();
-  assert(nCts <= nUtils);
+  for(ConcreteMkTaskset* cts: ctss) {
+    
+    const vector<MkSimulation*>& mkss = cts->getMkSimulations();
+    for (MkSimulation* mksim: mkss) {
+      mkSimToCts.erase(mksim);
+    }
+    ctsToSs.erase(cts);
+  }
+  dssToGenSeed.erase(dss);
+  list<MkDseSimulationSet*>::iterator it = simulationSets.begin();
+  while (it != simulationSets.end() && *it != dss) {
+    ++it;
+  }
+  if (*it == dss) {
+    simulationSets.erase(it);
+    delete dss;
+  }
+  else {
+    tError() << "Could not delete simulation set " << dss;
+  }
+  
+}
 
-  MkSimulation* allsims[nEvals][nCts];
-  //bitmap_t maps[nEvals];
-  Bitmap* maps[nEvals];
-  bitmap_t anomalies = 0;
-  map<MkSimulation*,ConcreteMkTaskset*> simToCts;
 
-  for (size_t i = 0; i < nEvals; ++i) {
-    maps[i] = new Bitmap(nUtils);
+
+list<MkBreakdownSearch*> generateSearches() {
+  list<MkBreakdownSearch*> searches;
+  if (theSeeds.size() != 0) {
+    unsigned int cSeed = theSeeds.front();
+    theSeeds.pop_front();
+    SearchSet* ss = new SearchSet;
+    ss->genSeed = cSeed;
+    ss->nFinished = 0;
+    // each search changes the utilisation of its task set, so every
+    // search needs its own copy
+    for (const MkEvalAllocatorPair* ap: theAllocators) {
+      AbstractMkTaskset* ats =
+	new AbstractMkTaskset(cSeed, theTasksetSize, gcfg,
+			      theUtilisationDeviation, theGenUtilisation,
+			      thePeriodGenerator);
+      MkBreakdownSearch* search =
+	new MkBreakdownSearch(ats, theGenUtilisation, theUtilisationStep,
+			      ap, scc, theBisectCheck);
+      ss->searches.push_back(search);
+      searches.push_back(search);
+    }
+    std::unique_lock<std::mutex> lck(mgtLock);
+    for (MkBreakdownSearch* search: searches) {
+      searchToSs[search] = ss;
+    }
   }
+  return searches;
+}
+
+
+MkBreakdownSearch* executeSearch(__attribute__((unused)) size_t tid, MkBreakdownSearch* search) {
+  search->search();
+  return search;
+}
 
+
+void processSearch(MkBreakdownSearch* search) {
+  {
+    std::unique_lock<std::mutex> lck(initLock);
+    while (!initialisationFinished) {
+      initCond.wait(lck);
+    }
+  }
+  std::unique_lock<std::mutex> lck(mgtLock);
+  SearchSet* ss = NULL;
+  try {
+    ss = searchToSs.at(search);
+  }
+  catch (const out_of_range& oor) {
+    tError() << "Search " << search << " not found in searchToSs Map!";
+    throw oor;
+  }
+  searchToSs.erase(search);
+  nSims += search->getProbes().size();
+  finishedSims += search->getProbes().size();
+
+  ++ss->nFinished;
+  if (ss->nFinished == ss->searches.size()) {
+    writeSearchLog(ss);
+    SeedResult sr;
+    getSearchResult(ss, sr);
+    commitResult(sr);
+    for (MkBreakdownSearch* s: ss->searches) {
+      delete s->getAts();
+      delete s;
+    }
+    delete ss;
+  }
+}
+
+
+void writeSearchLog(SearchSet* ss) {
+  ostringstream oss;
+  const AbstractMkTaskset* ats = ss->searches.front()->getAts();
+  oss << theLogPrefix << "-ts-" << ats->getSeed() << ".log";
+  ofstream simLog(oss.str(), ios::out | ios::trunc);
+
+  simLog << "Hyperperiod: " << ats->getHyperPeriod() << endl;
+  simLog << "FeasibilityMultiplicator: " << ats->getMkFeasibilityMultiplicator() << endl;
+  simLog << "MKP-FeasibilityPeriod: " << ats->getMkpFeasibilityPeriod() << endl;
+
+  simLog << "Abstract tasks: " << *ats << endl;
+
+  for (MkBreakdownSearch* search: ss->searches) {
+    for (const MkBreakdownSearch::Probe& p: search->getProbes()) {
+      const MkTaskset* mkts = p.mkTaskset;
+      simLog << endl;
+      simLog << "Utilisation: " << mkts->targetUtilisation
+	     << " U_r: " << mkts->realUtilisation
+	     << " U_mk: " << mkts->mkUtilisation
+	     << " S: " << mkts->suffMKSched
+	     << endl;
+      simLog << p.simulation->getSimulationMessage() << endl;
+
+      const std::list<MkTask*>& tasks = p.simulation->getMkTasks();
+      GstSimulation* mkets = dynamic_cast<GstSimulation*>(p.simulation);
+      if (mkets != NULL) {
+	simLog << "\t";
+	const CompressedMkState* states = mkets->getLastMkStates();
+	size_t i = 0;
+	for (MkTask* task: tasks) {
+	  simLog << " ";
+	  printBitString(simLog, states[i], task->getK());
+	  ++i;
+	}
+	simLog << endl;
+      }
+
+      if (theToFile) {
+	ostringstream oss;
+	oss << theXmlPrefix << "-" << mkts->targetUtilisation << "-" << ats->getSeed() << "-raw.xml";
+	vector<Task*> rtasks(mkts->tasks.begin(), mkts->tasks.end());
+	TasksetWriter* tsw = TasksetWriter::getInstance();
+	if (!tsw->write(oss.str(), rtasks)) {
+	  tError() << "Writing task set failed!";
+	}
+      }
+
+      if (p.simulation->getSuccess() && theToFile) {
+	ostringstream oss;
+	oss << theXmlPrefix << "-" << mkts->targetUtilisation << "-" << ats->getSeed() << "-" << p.simulation->getAllocId() << ".xml";
+
+	vector<Task*> wtasks;
+	for (MkTask* t: tasks) {
+	  wtasks.push_back(new MkTask(t));
+	}
+
+	TasksetWriter* tsw = TasksetWriter::getInstance();
+	bool result = tsw->write(oss.str(), wtasks);
+	if (!result) {
+	  tError() << "Writing task set failed!";
+	}
+	for (Task* t: wtasks) {
+	  delete t;
+	}
+	wtasks.clear();
+      }
+    }
+    simLog << endl;
+    string map = search->getMapStr();
+    simLog << search->getAllocator()->id << ": " << map;
+    if (search->getAnomaly())
+      simLog << " anomaly";
+    else if (map.find(MkBreakdownSearch::R_UNKNOWN) != string::npos)
+      simLog << " (monotonic schedulability assumed)";
+    simLog << endl;
+  }
+}
+
+
+void getDssResult(MkDseSimulationSet* dss, SeedResult& sr) {
+  const std::vector<ConcreteMkTaskset*>& ctss = dss->getCtss();
+  size_t nCts = ctss.size();
+  assert(nCts <= nUtils);
+
+  sr.genSeed = dssToGenSeed.at(dss);
+  sr.seed = dss->getAts()->getSeed();
+  sr.nSims = 0;
+  sr.utils.resize(nCts);
+  sr.maps.assign(nEvals, string(nCts, '0'));
   for (size_t ui = 0; ui < nCts; ++ui) {
-    ConcreteMkTaskset* cts = ctss[ui];
-    const vector<MkSimulation*>& sims = cts->getMkSimulations();
+    const MkTaskset* mkts = ctss[ui]->getMkTaskset();
+    sr.utils[ui].target = mkts->targetUtilisation;
+    sr.utils[ui].real = mkts->realUtilisation;
+    sr.utils[ui].mk = mkts->mkUtilisation;
+    const vector<MkSimulation*>& sims = ctss[ui]->getMkSimulations();
     assert(sims.size() == nEvals);
+    sr.nSims += sims.size();
     for (size_t ei = 0; ei < sims.size(); ++ei) {
-      MkSimulation* sim = sims[ei];
-      allsims[ei][ui] = sim;
-      simToCts[sim] = cts;
-      if (sim->getSuccess()) {
-	//maps[ei] |= ((bitmap_t)1) << (nUtils - 1 - ui);
-	(*maps[ei])[ui] = 1;
-	++nSuccesses[ei];
+      if (sims[ei]->getSuccess()) {
+	sr.maps[ei][ui] = '1';
       }
     }
   }
+}
+
+
+void getSearchResult(SearchSet* ss, SeedResult& sr) {
+  size_t nCts = ss->searches.front()->getNUtils();
+  assert(nCts <= nUtils);
+
+  sr.genSeed = ss->genSeed;
+  sr.seed = ss->searches.front()->getAts()->getSeed();
+  sr.nSims = 0;
+  UtilisationPoint unknown = { 0, 0, 0 };
+  sr.utils.assign(nCts, unknown);
+  sr.maps.clear();
+  for (MkBreakdownSearch* search: ss->searches) {
+    for (const MkBreakdownSearch::Probe& p: search->getProbes()) {
+      sr.utils[p.index].target = p.mkTaskset->targetUtilisation;
+      sr.utils[p.index].real = p.mkTaskset->realUtilisation;
+      sr.utils[p.index].mk = p.mkTaskset->mkUtilisation;
+    }
+    sr.nSims += search->getProbes().size();
+    sr.maps.push_back(search->getMapStr());
+  }
+}
+
+
+void writeToGlobalLogs(const SeedResult& sr) {
+  bitmap_t anomalies = 0;
 
-  *bdfLog << dss->getAts()->getSeed() << " ;";
-  *bdlLog << dss->getAts()->getSeed() << " ;";
+  *bdfLog << sr.seed << " ;";
+  *bdlLog << sr.seed << " ;";
 
   double bdfMax = 0.0;
   double bdlMax = 0.0;
   list<string> maxfList;
   list<string> maxlList;
 
-  
-  // first BD
   for (size_t ei = 0; ei < nEvals; ++ei) {
-    MkSimulation* first = NULL;
-    for (size_t ui = 0; ui < nCts; ++ui) {
-      if (allsims[ei][ui]->getSuccess()) {
-	first = allsims[ei][ui];
-      }
-      else {
-	break;
+    const string& map = sr.maps[ei];
+    // first BD: last success before the first failure, grid points
+    // that were not simulated are skipped
+    int first = -1;
+    for (size_t ui = 0; ui < map.size() && map[ui] != '0'; ++ui) {
+      if (map[ui] == '1') {
+	first = ui;
       }
     }
-    if (first != NULL) {
-      ConcreteMkTaskset* cts = simToCts[first];
-      const MkTaskset* mkts = cts->getMkTaskset();
+    // last BD: highest success
+    size_t pos = map.find_last_of('1');
+    int last = pos == string::npos ? -1 : pos;
 
-      if (bdfMax < mkts->targetUtilisation) {
+    if (first >= 0) {
+      const UtilisationPoint& up = sr.utils[first];
+
+      if (bdfMax < up.target) {
 	maxfList.clear();
-	bdfMax = mkts->targetUtilisation;
+	bdfMax = up.target;
 	maxfList.push_back(theAllocators[ei]->id);
       }
-      else if (bdfMax == mkts->targetUtilisation) {
+      else if (bdfMax == up.target) {
 	maxfList.push_back(theAllocators[ei]->id);
       }
             
-      *bdfLog << " [ " << mkts->targetUtilisation
-	      << " ; " << mkts->realUtilisation
-	      << " ; " << mkts->mkUtilisation
+      *bdfLog << " [ " << up.target
+	      << " ; " << up.real
+	      << " ; " << up.mk
 	      << " ]";
-   
     }
     else {
       *bdfLog << " [ 0 ; 0 ; 0 ]";
     }
 
-    // last BD
-    MkSimulation* last = NULL;
-    for (size_t ui = 0; ui < nCts; ++ui) {
-      if (allsims[ei][ui]->getSuccess()) {
-	last = allsims[ei][ui];
-      }
-    }
-    if (last != NULL) {
-      ConcreteMkTaskset* cts = simToCts[last];
-      const MkTaskset* mkts = cts->getMkTaskset();
+    if (last >= 0) {
+      const UtilisationPoint& up = sr.utils[last];
 
-      if (bdlMax < mkts->targetUtilisation) {
+      if (bdlMax < up.target) {
 	maxlList.clear();
-	bdlMax = mkts->targetUtilisation;
+	bdlMax = up.target;
 	maxlList.push_back(theAllocators[ei]->id);
       }
-      else if (bdlMax == mkts->targetUtilisation) {
+      else if (bdlMax == up.target) {
 	maxlList.push_back(theAllocators[ei]->id);
       }
             
-      *bdlLog << " [ " << mkts->targetUtilisation
-	      << " ; " << mkts->realUtilisation
-	      << " ; " << mkts->mkUtilisation
+      *bdlLog << " [ " << up.target
+	      << " ; " << up.real
+	      << " ; " << up.mk
 	      << " ]";
     }
     else {
       *bdlLog << " [ 0 ; 0 ; 0 ]";
     }
 
+    if (theBisect) {
+      // if schedulability is monotonic, unsimulated points below the
+      // breakdown succeed and those above it fail
+      nSuccesses[ei] += count(map.begin(), map.begin() + first + 1, '-')
+	+ count(map.begin(), map.end(), '1');
+    }
+    else {
+      nSuccesses[ei] += count(map.begin(), map.end(), '1');
+    }
+
     // Anomalies?
     if (first != last) {
       anomalies |= 1 << (nEvals - 1 - ei);
-      //cout << "Anomaly at ei=" << ei << endl;
     }
-    
   }
   
   *bdfLog << " {";
@@ -934,70 +1411,113 @@ void writeDssToGlobalLogs(MkDseSimulationSet* dss) {
   *bdlLog << " }";
   *bdlLog << endl;
 
-
-  *mapLog << dss->getAts()->getSeed();
-  for (size_t i = 0; i < nEvals; ++i) {
-    *mapLog << " ";
-    //printBitString(*mapLog, maps[i], nUtils);
-    *mapLog << maps[i]->str();
+  // utilisations above the grid of this task set have U_mk > 1
+  *mapLog << sr.seed;
+  for (const string& map: sr.maps) {
+    *mapLog << " " << map << string(nUtils - map.size(), '0');
   }
   *mapLog << endl;
 
-  *anLog << dss->getAts()->getSeed() << " " << strBitString(anomalies, nEvals) << endl;;
+  *anLog << sr.seed << " " << strBitString(anomalies, nEvals) << endl;;
+}
+
 
-  for (size_t i = 0; i < nEvals; ++i) {
-    delete maps[i];
+string journalHeader() {
+  ostringstream oss;
+  oss << setprecision(17) << "mkdse"
+      << " t=" << theTasksetSize
+      << " U=" << theGenUtilisation
+      << " u=" << theUtilisationStep
+      << " d=" << theUtilisationDeviation
+      << " n=" << theSteps
+      << " restrict-periods=" << vm.count("restrict-periods")
+      << " bisect=" << theBisect;
+  if (theBisectCheck == MkBreakdownSearch::C_SCAN) {
+    // only written if set, so journals of older runs stay valid
+    oss << " bisect-verify=1";
   }
-
+  oss << " a=";
+  for (const MkEvalAllocatorPair* ap: theAllocators) {
+    oss << ap->id << ",";
+  }
+  return oss.str();
 }
 
 
-void signalHandler(int signo) {
-  std::unique_lock<std::mutex> lck(mgtLock);
-  if (signo != SIGUSR1) {
-    cerr << "Not configured to handle signal " << signo << endl;
+string toJournalRecord(const SeedResult& sr) {
+  ostringstream oss;
+  oss << setprecision(17)
+      << sr.genSeed << " " << sr.seed << " " << sr.nSims
+      << " " << sr.utils.size();
+  for (const UtilisationPoint& up: sr.utils) {
+    oss << " " << up.target << " " << up.real << " " << up.mk;
   }
-  for (size_t i = 0; i < theNThreads; ++i) {
-    cout << "T" << i << ": ";
-    MkSimulation* sim = currentSim[i];
-    if (sim == NULL) {
-      cout << "NULL" << endl;
+  if (!sr.utils.empty()) {
+    for (const string& map: sr.maps) {
+      oss << " " << map;
     }
-    else {
-      ConcreteMkTaskset* cts = mkSimToCts.at(sim);
-      MkDseSimulationSet* mss = ctsToSs.at(cts);
-      cout << mss->getAts()->getSeed() << "-" << sim->getAllocId()
-	   << "@" << cts->getMkTaskset()->targetUtilisation
-	   << " (C: " << sim->getSimulation()->getTime() << ")"
-	   << endl;
+  }
+  return oss.str();
+}
+
+
+bool fromJournalRecord(const string& record, SeedResult& sr) {
+  istringstream iss(record);
+  size_t nCts;
+  if (!(iss >> sr.genSeed >> sr.seed >> sr.nSims >> nCts)) {
+    return false;
+  }
+  sr.utils.resize(nCts);
+  for (UtilisationPoint& up: sr.utils) {
+    if (!(iss >> up.target >> up.real >> up.mk))
+      return false;
+  }
+  sr.maps.assign(nEvals, "");
+  if (nCts > 0) {
+    for (string& map: sr.maps) {
+      if (!(iss >> map) || map.size() != nCts)
+	return false;
     }
   }
-  cout << "Finished: " << finishedSims << "/" << nSims << endl;
-  cout << endl;
+  return true;
 }
 
 
-void cleanupDss(MkDseSimulationSet* dss) {
-  const std::vector<ConcreteMkTaskset*>& ctss = dss->getCtss();
-  for(ConcreteMkTaskset* cts: ctss) {
-    
-    const vector<MkSimulation*>& mkss = cts->getMkSimulations();
-    for (MkSimulation* mksim: mkss) {
-      mkSimToCts.erase(mksim);
+void skipFinishedSeeds() {
+  list<SeedResult>::iterator rit = replayResults.begin();
+  while (rit != replayResults.end()) {
+    list<unsigned int>::iterator sit = find(theSeeds.begin(), theSeeds.end(), rit->genSeed);
+    if (sit != theSeeds.end()) {
+      theSeeds.erase(sit);
+      ++rit;
+    }
+    else {
+      tWarn() << "Seed " << rit->genSeed << " from journal is not in the seed list, ignoring it";
+      rit = replayResults.erase(rit);
     }
-    ctsToSs.erase(cts);
   }
-  list<MkDseSimulationSet*>::iterator it = simulationSets.begin();
-  while (it != simulationSets.end() && *it != dss) {
-    ++it;
+  cout << "==INFO== " << "\tResuming: " << replayResults.size()
+       << " seeds finished, " << theSeeds.size() << " left" << endl;
+}
+
+
+void replayJournal() {
+  std::unique_lock<std::mutex> lck(mgtLock);
+  for (const SeedResult& sr: replayResults) {
+    writeToGlobalLogs(sr);
+    nSims += sr.nSims;
+    finishedSims += sr.nSims;
   }
-  if (*it == dss) {
-    simulationSets.erase(it);
-    delete dss;
+  replayResults.clear();
+}
+
+
+void commitResult(const SeedResult& sr) {
+  if (theShard >= 0) {
+    theShards->send(toJournalRecord(sr));
   }
   else {
-    tError() << "Could not delete simulation set " << dss;
+    writeToGlobalLogs(sr);
+    theJournal->append(toJournalRecord(sr));
   }
-  
 }
-
@@ -30,6 +30,7 @@
 
 #include <mkeval/mkeval.h>
 #include <mkeval/mkallocators.h>
+#include <core/lockstepsimulation.h>
 //#include <core/stat.h>
 
 #include <utils/tlogger.h>
@@ -100,7 +101,12 @@ namespace tmssim {
   void MkEval::run() {
     for (unsigned int i = 0; i < nSchedulers; ++i) {
       prepareEval(i);
-      runEval(i);
+    }
+    // all schedulers share one activation calendar
+    LockstepSimulation lockstep(vector<Simulation*>(simulations, simulations + nSchedulers));
+    vector<Simulation::ExitCondition> rres = lockstep.run(steps);
+    for (unsigned int i = 0; i < nSchedulers; ++i) {
+      finishEval(i, rres[i]);
     }
   }
 
@@ -141,14 +147,12 @@ namespace tmssim {
       ts->push_back(task);
       mkts[num]->push_back(task);
     }
-    simulations[num] = new Simulation(ts, allocators[num]->schedAlloc(schedulerConfiguration)); // FIXME: take from exec config
+    simulations[num] = MkAllocators::instance().newSimulation(ts, allocators[num]->schedAlloc(schedulerConfiguration)); // FIXME: take from exec config
   }
 
 
-  void MkEval::runEval(unsigned int num) {
+  void MkEval::finishEval(unsigned int num, Simulation::ExitCondition rres) {
     assert(num < nSchedulers);
-    Simulation::ExitCondition rres;
-    rres = simulations[num]->run(steps);
     if (rres == 0) {
       rres = simulations[num]->finalise();
     }
@@ -138,10 +138,12 @@ namespace tmssim {
     void prepareEval(unsigned int num);
 
     /**
-     * @brief Perform one simulation (with one scheduler).
+     * @brief Finalise one simulation (with one scheduler) after the
+     * lock-step run and evaluate its results.
      * @param num in 0...nSchedulers-1
+     * @param rres exit condition of the run
      */
-    void runEval(unsigned int num);
+    void finishEval(unsigned int num, Simulation::ExitCondition rres);
     
 
     /// The taskset that is evaluated
@@ -128,7 +128,7 @@ namespace tmssim {
 
   struct BdResultData {
   BdResultData()
-  : breakdownUtilisation(0), realUtilisation(0), mkUtilisation(0) {}
+  : breakdownUtilisation(0), realUtilisation(0), mkUtilisation(0), success(false) {}
   BdResultData(double bdu, double ru, double mku, bool succ=false)
   : breakdownUtilisation(bdu), realUtilisation(ru), mkUtilisation(mku), success(succ) {}
     
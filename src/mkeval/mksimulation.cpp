@@ -30,6 +30,7 @@
  */
 
 #include <mkeval/mksimulation.h>
+#include <mkeval/mkallocators.h>
 
 namespace tmssim {
 
@@ -42,7 +43,7 @@ namespace tmssim {
     for (MkTask* task: mkTasks) {
       simTasks->push_back(task);
     }
-    simulation = new Simulation(simTasks, scheduler);// Simulation::EC_CANCEL);
+    simulation = MkAllocators::instance().newSimulation(simTasks, scheduler);// Simulation::EC_CANCEL);
   }
 
   
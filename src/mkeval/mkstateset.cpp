@@ -0,0 +1,109 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file mkstateset.cpp
+ * @brief Hash set of (m,k)-states of task sets
+ */
+
+#include <mkeval/mkstateset.h>
+
+using namespace std;
+
+namespace tmssim {
+
+  const size_t MkStateSet::EMPTY;
+
+  /// initial number of hash slots, must be a power of 2
+  static const size_t INITIAL_SLOTS = 16;
+
+
+  MkStateSet::MkStateSet(size_t _width)
+    : width(_width), count(0), slots(INITIAL_SLOTS, EMPTY) {
+  }
+
+
+  bool MkStateSet::insert(const CompressedMkState* state) {
+    size_t slot = findSlot(state);
+    if (slots[slot] != EMPTY)
+      return false;
+    store.insert(store.end(), state, state + width);
+    slots[slot] = count;
+    ++count;
+    // keep load factor below 1/2
+    if (2 * count > slots.size())
+      grow();
+    return true;
+  }
+
+
+  bool MkStateSet::contains(const CompressedMkState* state) const {
+    return slots[findSlot(state)] != EMPTY;
+  }
+
+
+  size_t MkStateSet::hash(const CompressedMkState* state) const {
+    uint64_t h = width;
+    for (size_t i = 0; i < width; ++i) {
+      // splitmix64 finaliser
+      uint64_t x = h ^ state[i];
+      x += 0x9e3779b97f4a7c15ULL;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      h = x ^ (x >> 31);
+    }
+    return h;
+  }
+
+
+  bool MkStateSet::equals(size_t index, const CompressedMkState* state) const {
+    const CompressedMkState* stored = &store[index * width];
+    for (size_t i = 0; i < width; ++i) {
+      if (stored[i] != state[i])
+	return false;
+    }
+    return true;
+  }
+
+
+  size_t MkStateSet::findSlot(const CompressedMkState* state) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash(state) & mask;
+    while (slots[slot] != EMPTY && !equals(slots[slot], state))
+      slot = (slot + 1) & mask;
+    return slot;
+  }
+
+
+  void MkStateSet::grow() {
+    vector<size_t> old(2 * slots.size(), EMPTY);
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (size_t index: old) {
+      if (index == EMPTY)
+	continue;
+      size_t slot = hash(&store[index * width]) & mask;
+      while (slots[slot] != EMPTY)
+	slot = (slot + 1) & mask;
+      slots[slot] = index;
+    }
+  }
+
+} // NS tmssim
@@ -0,0 +1,84 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file mkstateset.h
+ * @brief Hash set of (m,k)-states of task sets
+ */
+
+#ifndef MKEVAL_MKSTATESET_H
+#define MKEVAL_MKSTATESET_H 1
+
+#include <taskmodels/mkmonitor.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Set of (m,k)-states of a whole task set.
+   *
+   * Each element is a vector of one CompressedMkState per task. All
+   * elements are packed into one array, the hash table only stores
+   * their indices (open addressing with linear probing). Insertion and
+   * lookup take O(n) for n tasks, independent of the number of stored
+   * states.
+   */
+  class MkStateSet {
+  public:
+    /**
+     * @param _width number of tasks, i.e. length of each state vector
+     */
+    MkStateSet(size_t _width);
+
+    /**
+     * @brief Add a state vector
+     * @param state array of #width states
+     * @return true, if the state was not yet contained
+     */
+    bool insert(const CompressedMkState* state);
+
+    /**
+     * @param state array of #width states
+     * @return true, if the state is contained in the set
+     */
+    bool contains(const CompressedMkState* state) const;
+
+    size_t size() const { return count; }
+
+  private:
+    static const size_t EMPTY = (size_t) -1;
+
+    size_t hash(const CompressedMkState* state) const;
+    bool equals(size_t index, const CompressedMkState* state) const;
+    /// slot that contains the state, or the empty slot where it belongs
+    size_t findSlot(const CompressedMkState* state) const;
+    void grow();
+
+    size_t width;
+    size_t count;
+    std::vector<CompressedMkState> store; ///< packed state vectors
+    std::vector<size_t> slots; ///< index into #store / #width, or #EMPTY
+  };
+
+} // NS tmssim
+
+#endif /* !MKEVAL_MKSTATESET_H */
@@ -29,17 +29,19 @@
  */
 
 #include <schedulers/ald.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 #include <utils/logger.h>
 
 #include <cassert>
 #include <iostream>
+#include <vector>
 using namespace std;
 
 namespace tmssim {
 
   ALDScheduler::ALDScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : Scheduler(), myConfig(schedulerConfiguration), currentJob(NULL), scheduleChanged(false) {
+    : Scheduler(), mySchedule(Job::QUEUE_SCHEDULE), jobQueue(&mySchedule), myConfig(schedulerConfiguration), execMissJobs(Job::QUEUE_MISSED), currentJob(NULL), scheduleChanged(false) {
     LOG(LOG_CLASS_SCHEDULER) << "Created ALDScheduler with "
 			     << "SCC EC: " << myConfig.execCancellations
 			     << " DLMC: " << myConfig.dlMissCancellations;
@@ -47,23 +49,22 @@ namespace tmssim {
 
 
   ALDScheduler::~ALDScheduler() {
-    list<Job*>::iterator it = mySchedule.begin();
-    while (it != mySchedule.end()) {
-      Job* job = *it;
+    destroyJobs(mySchedule);
+  }
+
+
+  void ALDScheduler::destroyJobs(JobQueue& queue) {
+    while (!queue.empty()) {
+      Job* job = queue.pop();
       tInfo() << "ALDScheduler destroys unfinished job " << *job;
       //<< " in instance of " << getId();
       delete job;
-      it = mySchedule.erase(it);
     }
   }
 
 
   const Job* ALDScheduler::removeJob(const Job *job) {
-    list<Job*>::iterator it = mySchedule.begin();
-    while (it != mySchedule.end() && *it != job)
-      it++;
-
-    if (it == mySchedule.end())
+    if (!jobQueue->contains(job))
       return NULL;
 
     // actual removal deferred -- first make sure job is either in
@@ -72,16 +73,11 @@ namespace tmssim {
     if (dlmon.removeJob(job) != job) {
       // job is not deadline-monitored, i.e. it has already missed its deadline
       // and thus should be in the execMissJobs list
-      list<const Job*>::iterator ite = execMissJobs.begin();
-      while ( ite != execMissJobs.end() && *ite != job ) {
-	ite++;
-      }
-      if (ite == execMissJobs.end()) {
+      if (!execMissJobs.remove(job)) {
 	// PROBLEM!
 	tError() << "Job " << *job << " not found in DlMon+execMissJobs!";
 	return NULL;
       }
-      execMissJobs.erase(ite);
     }
 
     /*
@@ -95,14 +91,9 @@ namespace tmssim {
 
 
   const Job* ALDScheduler::internalRemoveJob(const Job *job) {
-    list<Job*>::iterator it = mySchedule.begin();
-    while (it != mySchedule.end() && *it != job)
-      it++;
-
-    if (it == mySchedule.end())
+    if (!jobQueue->remove(job))
       return NULL;
-
-    mySchedule.erase(it);
+    jobRemoved(job);
 
     if (job == currentJob) {
       currentJob = NULL;
@@ -141,13 +132,12 @@ namespace tmssim {
   }
   
 
-  Job* ALDScheduler::dispatch(TmsTime now, DispatchStat& dispatchStat) {
-    printSchedule();
+  void ALDScheduler::selectCurrentJob() {
     Job* prevJob = currentJob;
     if (currentJob == NULL || scheduleChanged) {
       // have to get (possibly) new job
-      if (mySchedule.size() > 0) {
-	currentJob = mySchedule.front();
+      if (!jobQueue->empty()) {
+	currentJob = jobQueue->top();
 	if (prevJob != NULL && prevJob != currentJob) {
 	  prevJob->preempt();
 	}
@@ -156,6 +146,13 @@ namespace tmssim {
 	currentJob = NULL;
       }
     }
+  }
+
+
+  Job* ALDScheduler::dispatch(TmsTime now, DispatchStat& dispatchStat) {
+    if (TLOG_ACTIVE(TLL_DEBUG))
+      printSchedule();
+    selectCurrentJob();
     // now we know which job is to be executed next (->currentJob)
 
     if (currentJob == NULL) { // no job -> idle
@@ -168,8 +165,9 @@ namespace tmssim {
       dispatchStat.executed = currentJob;
       if (fin) { // (currentJob->etRemain == 0) {
 	Job* finishedJob = currentJob;
-	assert(finishedJob == mySchedule.front());
-	mySchedule.pop_front();
+	assert(finishedJob == jobQueue->top());
+	jobQueue->pop();
+	jobRemoved(finishedJob);
 	if (finishedJob->getAbsDeadline() <= now) {
 	  dispatchStat.dlMiss = true;
 	}
@@ -180,20 +178,8 @@ namespace tmssim {
 	currentJob = NULL;
 
 	if (finishedJob->getAbsDeadline() <= now) {
-	  // job has missed its deadline, search in execMissJobs list
-	  list<const Job*>::iterator it = execMissJobs.begin();
-	  while (it != execMissJobs.end()) {
-	    if (*it == finishedJob) {
-	      break;
-	    }
-	    else {
-	      ++it;
-	    }
-	  }
-	  if (it != execMissJobs.end()) {
-	    // found job!
-	  }
-	  else {
+	  // job has missed its deadline, remove it from execMissJobs list
+	  if (!execMissJobs.remove(finishedJob)) {
 	    LOG(LOG_CLASS_SCHEDULER) << "Could not find DL-miss job "
 				     << finishedJob << " (" << *finishedJob
 				     << ") in execMissJobs list (now = "
@@ -213,6 +199,7 @@ namespace tmssim {
 	return finishedJob;
       }
       else {
+	jobExecuted(currentJob);
 	if (dlmon.jobExecuted(currentJob) != currentJob) {
 	  //tError() << "Notifying dlmon failed! " << exc << " " << *exc;
 	  // Don't care about this, the job should be in the execMissJobs list
@@ -223,23 +210,92 @@ namespace tmssim {
   }
 
 
+  TmsTime ALDScheduler::getNextEventTime(TmsTime now) const {
+    const Job* nextJob = currentJob;
+    if (nextJob == NULL || scheduleChanged) {
+      if (jobQueue->empty())
+	return TMS_TIME_MAX;
+      nextJob = jobQueue->top();
+    }
+    // the executing job finishes after its remaining execution time
+    TmsTime next = now + nextJob->getRemainingExecutionTime();
+    if (myConfig.dlMissCancellations) {
+      // initStep checks the executing job before it is dispatched, but
+      // executing it keeps its slack constant
+      if (nextJob->getLatestStartTime() <= now)
+	return now + 1;
+      // the latest start times of all other jobs are fixed
+      TmsTime check = dlmon.getNextCheckTime(nextJob);
+      if (check < next)
+	next = check;
+    }
+    return next;
+  }
+
+
+  int ALDScheduler::advance(TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat) {
+    selectCurrentJob();
+    if (currentJob == NULL) {
+      dispatchStat.idle = true;
+      return 0;
+    }
+    LOG(LOG_CLASS_SCHEDULER) << "\tExecuting job " << *currentJob
+			     << " for " << steps << " steps";
+    if (currentJob->execSteps(now, steps)) {
+      // job must not finish within an interval without events
+      return ESC_DISP_COMP;
+    }
+    dispatchStat.executed = currentJob;
+    jobExecuted(currentJob);
+    dlmon.jobExecuted(currentJob);
+    return 0;
+  }
+
+
   bool ALDScheduler::hasPendingJobs(void) const {
-    return mySchedule.size() > 0;
+    return !jobQueue->empty();
   }
 
 
   void ALDScheduler::printSchedule() const {
-    for (list<Job*>::const_iterator it = mySchedule.begin();
-	 it != mySchedule.end(); ++it) {
-      tDebug() << "\t" << **it;
+    vector<const Job*> jobs;
+    jobQueue->getJobs(jobs);
+    for (const Job* job: jobs) {
+      tDebug() << "\t" << *job;
     }
   }
 
 
+  bool ALDScheduler::writeState(StateSnapshot& snapshot) const {
+    vector<const Job*> jobs;
+    jobQueue->getJobs(jobs);
+    snapshot.add(jobs.size());
+    for (const Job* job: jobs) {
+      snapshot.addJob(job);
+    }
+    dlmon.writeState(snapshot);
+    snapshot.add(execMissJobs.size());
+    for (const Job* job: execMissJobs) {
+      snapshot.addJobRef(job);
+    }
+    snapshot.addJobRef(currentJob);
+    snapshot.add(scheduleChanged);
+    return true;
+  }
+
+
   void ALDScheduler::jobFinished(__attribute__((unused)) Job *job) {
   }
 
 
+  void ALDScheduler::jobRemoved(__attribute__((unused)) const Job *job) {
+  }
+
+
+  void ALDScheduler::jobExecuted(__attribute__((unused)) Job *job) {
+  }
+
+
   void ALDScheduler::jobEnqueued(Job *job) {
     dlmon.addJob(job);
   }
@@ -30,6 +30,8 @@
 #include <core/scheduler.h>
 #include <core/scconfig.h>
 #include <core/deadlinemonitor.h>
+#include <core/joblist.h>
+#include <core/jobqueue.h>
 
 #include <list>
 
@@ -102,6 +104,27 @@ namespace tmssim {
      */
     virtual Job* dispatch(TmsTime now, DispatchStat& dispatchStat);
 
+    /**
+     * @brief Find the next scheduling event.
+     *
+     * Without new activations, the schedule can only change when the
+     * first job of ALDScheduler::mySchedule finishes, or when the
+     * deadline monitor finds a job that will miss its deadline.
+     * @param now the last simulated time step
+     * @return time of the next scheduling event
+     */
+    virtual TmsTime getNextEventTime(TmsTime now) const;
+
+    /**
+     * @brief Execute the first job of ALDScheduler::mySchedule for
+     * several time steps.
+     * @param now first time step of the interval
+     * @param steps length of the interval
+     * @param dispatchStat Container for statistics
+     * @return 0 on success, ESC_DISP error code else
+     */
+    virtual int advance(TmsTime now, TmsTimeInterval steps, DispatchStat& dispatchStat);
+
     /**
      * @brief Check wether there are active jobs.
      * @return <b>true</b> if there are active jobs.
@@ -113,6 +136,12 @@ namespace tmssim {
      */
     virtual void printSchedule() const;
 
+    /**
+     * @brief Write the schedule, the monitored jobs and the currently
+     * executed job.
+     */
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
   protected:
 
     /**
@@ -137,6 +166,26 @@ namespace tmssim {
      */
     virtual void jobFinished(Job *job);
 
+    /**
+     * @brief Notification that a job was removed from the schedule.
+     *
+     * This method is called whenever a job leaves #jobQueue: if it
+     * finished execution, was cancelled by initStep(),
+     * or was removed through removeJob(). Overwrite it if you keep
+     * additional data structures that mirror the schedule.
+     * @param job the removed job
+     */
+    virtual void jobRemoved(const Job *job);
+
+    /**
+     * @brief Notification that a job was executed, but has not finished.
+     *
+     * Called by dispatch() and advance() after the remaining execution
+     * time of the job has decreased.
+     * @param job the executed job
+     */
+    virtual void jobExecuted(Job *job);
+
 
     /*
      * @brief Notification that a job was cancelled.
@@ -157,6 +206,15 @@ namespace tmssim {
      */
     virtual void notifyScheduleChanged();
 
+    /**
+     * @brief Delete all jobs that are still kept in a queue.
+     *
+     * This is only the last resort for the destructors of the owners of
+     * the queues, actually, child classes should take care of cleaning
+     * up their queues!
+     */
+    static void destroyJobs(JobQueue& queue);
+
 
     /**
      * @brief List holding the current schedule.
@@ -165,7 +223,18 @@ namespace tmssim {
      * implementation. Dispatching is performed from the front.
      * This list may be altered by the ALDScheduler::dispatch() method
      */
-    std::list<Job*> mySchedule;
+    JobList mySchedule;
+
+    /**
+     * @brief The queue from which jobs are dispatched, #mySchedule by
+     * default.
+     *
+     * Schedulers that keep their jobs in a different container (e.g. a
+     * JobHeap) point this to the container in their constructor and
+     * insert the jobs there, all other operations are performed by
+     * ALDScheduler through this interface.
+     */
+    JobQueue* jobQueue;
 
     
     /**
@@ -183,7 +252,7 @@ namespace tmssim {
     /**
      * @brief Jobs that miss their deadline but must still be executed.
      */
-    std::list<const Job*> execMissJobs;
+    JobList execMissJobs;
 
     
   private:
@@ -195,6 +264,15 @@ namespace tmssim {
      * @return The removed job, or <b>NULL</b> if the job is not in the schedule
      */
     const Job* internalRemoveJob(const Job *job);
+
+    /**
+     * @brief Select the job to execute in the current time step.
+     *
+     * Sets ALDScheduler::currentJob to the first job of
+     * ALDScheduler::mySchedule if the schedule has changed, and
+     * preempts the previously executed job if necessary.
+     */
+    void selectCurrentJob();
     
     /**
      * @brief The Job that is currently being executed/was executed
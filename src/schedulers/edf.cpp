@@ -33,7 +33,6 @@
 #include <cassert>
 #include <climits>
 #include <cstddef>
-#include <list>
 
 #include <iostream>
 
@@ -43,33 +42,87 @@ using namespace std;
 namespace tmssim {
 
   static const std::string myId = "EDFScheduler";
+
+
+  static TmsTime deadlineKey(const Job* job) {
+    return job->getAbsDeadline();
+  }
   
   
   EDFScheduler::EDFScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : ALDScheduler(schedulerConfiguration) {
+    : ALDScheduler(schedulerConfiguration), useSlackTree(false),
+      useReadyHeap(myConfig.heapReadyQueue), readyHeap(Job::QUEUE_SCHEDULE) {
+    if (useReadyHeap)
+      jobQueue = &readyHeap;
+  }
+
+
+  EDFScheduler::EDFScheduler(const SchedulerConfiguration& schedulerConfiguration, bool sortedSchedule)
+    : ALDScheduler(schedulerConfiguration), useSlackTree(sortedSchedule),
+      useReadyHeap(myConfig.heapReadyQueue && !sortedSchedule),
+      readyHeap(Job::QUEUE_SCHEDULE) {
+    if (useReadyHeap)
+      jobQueue = &readyHeap;
   }
   
   
   EDFScheduler::~EDFScheduler() {
+    destroyJobs(readyHeap);
   }
   
 
   void EDFScheduler::enqueueJob(Job *job) {
     assert(job->getTask() != NULL);
     assert((long long)job->getTask() < 0x800000000000LL); // WTF???
-    std::list<Job*>::iterator it = mySchedule.begin();
+    if (useReadyHeap) {
+      readyHeap.push(job, job->getAbsDeadline());
+      notifyScheduleChanged();
+      jobEnqueued(job);
+      return;
+    }
+    JobList::iterator it = mySchedule.begin();
     while ( it != mySchedule.end()
 	    && *it != NULL
 	    && (*it)->getAbsDeadline() <= job->getAbsDeadline() ) {
       it++;
     }
     mySchedule.insert(it, job);
+    if (useSlackTree)
+      slackTree.insert(job);
     notifyScheduleChanged();
     jobEnqueued(job);
     //return true;
   }
 
 
+  void EDFScheduler::enqueueJobs(const std::vector<Job*>& jobs) {
+    if (useReadyHeap) {
+      Scheduler::enqueueJobs(jobs);
+      return;
+    }
+    // sort by deadline, jobs with equal deadlines stay in the order of
+    // the batch
+    sortJobs(jobs.begin(), jobs.end(), deadlineKey, batchJobs);
+    // each job is placed behind all jobs with the same deadline, like
+    // in enqueueJob, so the merge can continue behind the previous job
+    JobList::iterator it = mySchedule.begin();
+    for (size_t i = 0; i < batchJobs.size(); ++i) {
+      while ( it != mySchedule.end()
+	      && *it != NULL
+	      && (*it)->getAbsDeadline() <= batchJobs[i].key ) {
+	it++;
+      }
+      mySchedule.insert(it, batchJobs[i].job);
+    }
+    for (Job* job: jobs) {
+      if (useSlackTree)
+	slackTree.insert(job);
+      jobEnqueued(job);
+    }
+    notifyScheduleChanged();
+  }
+
+
   int EDFScheduler::schedule(__attribute__((unused)) TmsTime now,
 			     __attribute__((unused)) ScheduleStat& scheduleStat) {
     // Deadline monitoring is done by ALDScheduler,
@@ -98,9 +151,23 @@ namespace tmssim {
   }
 
 
+  void EDFScheduler::jobRemoved(const Job *job) {
+    if (useSlackTree)
+      slackTree.remove(job);
+  }
+
+
+  void EDFScheduler::jobExecuted(Job *job) {
+    if (useSlackTree)
+      slackTree.update(job);
+  }
+
+
   const Job* EDFScheduler::checkEDFSchedule(TmsTime now) const {
+    if (useSlackTree)
+      return slackTree.firstMiss(now);
     TmsTime time = now;
-    for (list<Job*>::const_iterator it = mySchedule.begin();
+    for (JobList::const_iterator it = mySchedule.begin();
 	 it != mySchedule.end(); ++it) {
       time += (*it)->getRemainingExecutionTime();
       if (time > (*it)->getAbsDeadline()) {
@@ -111,9 +178,9 @@ namespace tmssim {
   }
 
 
-  const Job* EDFScheduler::checkEDFSchedule(TmsTime now, const list<Job*>& schedule) {
+  const Job* EDFScheduler::checkEDFSchedule(TmsTime now, const JobList& schedule) {
     TmsTime time = now;
-    for (list<Job*>::const_iterator it = schedule.begin();
+    for (JobList::const_iterator it = schedule.begin();
 	 it != schedule.end(); ++it) {
       time += (*it)->getRemainingExecutionTime();
       if (time > (*it)->getAbsDeadline()) {
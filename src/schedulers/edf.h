@@ -28,11 +28,21 @@
 #define SCHEDULERS_EDF_H 1
 
 #include <schedulers/ald.h>
+#include <core/edfslacktree.h>
+#include <core/jobheap.h>
+#include <core/jobsort.h>
+
+#include <vector>
 
 namespace tmssim {
 
   /**
    * @brief Earliest deadline first scheduler
+   *
+   * If SchedulerConfiguration::heapReadyQueue is set, the jobs are kept
+   * in #readyHeap instead of the sorted ALDScheduler::mySchedule list.
+   * Subclasses that need the complete sorted schedule (e.g. for
+   * #checkEDFSchedule) always use the list.
    * @todo implement deadline monitoring, cancel job if deadline miss
    * is pending.
    */
@@ -44,6 +54,12 @@ namespace tmssim {
 
     virtual void enqueueJob(Job *job);
 
+    /**
+     * Sorts the batch by deadline and merges it into the schedule in
+     * a single pass.
+     */
+    virtual void enqueueJobs(const std::vector<Job*>& jobs);
+
       
     /**
      * This function checks whether the first job in the queue, i.e. the
@@ -61,9 +77,21 @@ namespace tmssim {
     //friend std::ostream& operator << (std::ostream& ost, const EDFScheduler& scheduler);
     
     static const Job* checkEDFSchedule(TmsTime now,
-				       const list<Job*>& schedule);
+				       const JobList& schedule);
     
   protected:
+    /**
+     * @brief C'tor for subclasses
+     * @param schedulerConfiguration
+     * @param sortedSchedule the subclass needs all jobs sorted in
+     * ALDScheduler::mySchedule, the ready heap is not used. Instead,
+     * #slackTree mirrors the schedule to speed up #checkEDFSchedule.
+     */
+    EDFScheduler(const SchedulerConfiguration& schedulerConfiguration, bool sortedSchedule);
+
+    virtual void jobRemoved(const Job *job);
+    virtual void jobExecuted(Job *job);
+
     /*
     virtual int doSchedule(int now, ScheduleStat& scheduleStat);
     virtual Job* doDispatch(int now, DispatchStat& dispatchStat);
@@ -84,6 +112,35 @@ namespace tmssim {
      */
     const Job* checkEDFSchedule(TmsTime now) const;
 
+    /**
+     * @brief Maintain #slackTree
+     */
+    bool useSlackTree;
+
+    /**
+     * @brief Contains the same jobs as ALDScheduler::mySchedule if
+     * #useSlackTree is set.
+     *
+     * Subclasses that change ALDScheduler::mySchedule directly must
+     * keep the tree consistent, e.g. by creating their schedule in the
+     * tree and copying it with EdfSlackTree::toList.
+     */
+    EdfSlackTree slackTree;
+
+  private:
+    /**
+     * @brief Keep the jobs in #readyHeap, which is then
+     * ALDScheduler::jobQueue
+     */
+    bool useReadyHeap;
+
+    /**
+     * @brief Ready jobs keyed by their absolute deadlines
+     */
+    JobHeap readyHeap;
+
+    /// Jobs of the current #enqueueJobs call, sorted by deadline
+    std::vector<KeyedJob<TmsTime> > batchJobs;
   };
 
 
@@ -40,11 +40,13 @@ namespace tmssim {
   static const std::string myId = "FPPScheduler";
   
   FPPScheduler::FPPScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : ALDScheduler(schedulerConfiguration) {
+    : ALDScheduler(schedulerConfiguration), priorityQueue(Job::QUEUE_SCHEDULE) {
+    jobQueue = &priorityQueue;
   }
 
 
   FPPScheduler::~FPPScheduler() {
+    destroyJobs(priorityQueue);
   }
 
   /*
@@ -63,13 +65,7 @@ namespace tmssim {
     tDebug() << "Enqueueing job " << *job << " @ " << job << " T@ " << job->getTask();
     assert(job->getTask() != NULL);
     assert((long long)job->getTask() < 0x800000000000LL);
-    std::list<Job*>::iterator it = mySchedule.begin();
-    while ( it != mySchedule.end()
-	    && *it != NULL
-	    && (*it)->getPriority() <= job->getPriority() ) {
-      it++;
-    }
-    mySchedule.insert(it, job);
+    priorityQueue.push(job);
     notifyScheduleChanged();
 
     //dlmon.addJob(job);
@@ -78,8 +74,20 @@ namespace tmssim {
   }
 
 
+  void FPPScheduler::enqueueJobs(const std::vector<Job*>& jobs) {
+    for (Job* job: jobs) {
+      tDebug() << "Enqueueing job " << *job << " @ " << job << " T@ " << job->getTask();
+      assert(job->getTask() != NULL);
+      priorityQueue.push(job);
+      jobEnqueued(job);
+    }
+    notifyScheduleChanged();
+  }
+
+
   int FPPScheduler::schedule(__attribute__((unused)) TmsTime now, __attribute__((unused)) ScheduleStat& scheduleStat) {
-    printSchedule();
+    if (TLOG_ACTIVE(TLL_DEBUG))
+      printSchedule();
     /*
     Job* missJob = NULL;
     while ( (missJob = (Job*)dlmon.check(now)) != NULL) {
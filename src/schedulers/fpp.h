@@ -27,6 +27,7 @@
 
 #include <schedulers/ald.h>
 #include <core/deadlinemonitor.h>
+#include <core/jobpriorityqueue.h>
 
 //#include <cstdint>
 /**
@@ -58,10 +59,18 @@ namespace tmssim {
      * Jobs are executed in ascending order of their priority values.
      * FPPScheduler::MAX_PRIORITY (0) represents the most important
      * jobs, jobs with priority FPPScheduler::MIN_PRIORITY (UINT_MAX)
-     * are executed last.
+     * are executed last. Jobs with equal priorities are executed in
+     * the order of their activation. The jobs are kept in
+     * #priorityQueue, so enqueueing is O(1).
      */
     virtual void enqueueJob(Job *job);
 
+    /**
+     * The priority queue needs no sorting, so the batch is only pushed
+     * job by job.
+     */
+    virtual void enqueueJobs(const std::vector<Job*>& jobs);
+
     /**
      * This function does nothing. You may overwrite it in subclasses
      * to e.g. check whether a schedule is feasible and, if not, make
@@ -92,7 +101,13 @@ namespace tmssim {
      * Jobs that miss their deadline but must still be executed.
      */
     //std::list<Job*> execMissJobs;
-    
+
+  private:
+    /**
+     * @brief The ready jobs, this is ALDScheduler::jobQueue
+     */
+    JobPriorityQueue priorityQueue;
+
   }; // class FPPScheduler
 
 
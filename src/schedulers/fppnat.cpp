@@ -29,6 +29,7 @@
  */
 
 #include <schedulers/fppnat.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 
 #include <cassert>
@@ -51,7 +52,7 @@ namespace tmssim {
     tDebug() << "Enqueueing job " << *job << " @ " << job << " T@ " << job->getTask();
     assert(job->getTask() != NULL);
     assert((long long)job->getTask() < 0x800000000000LL);
-    std::list<Job*>::iterator it = mySchedule.begin();
+    JobList::iterator it = mySchedule.begin();
     while ( it != mySchedule.end()
 	    && *it != NULL
 	    && (*it)->getPriority() >= job->getPriority() ) {
@@ -66,7 +67,8 @@ namespace tmssim {
 
 
   int FPPNatScheduler::schedule(TmsTime now, ScheduleStat& scheduleStat) {
-    printSchedule();
+    if (TLOG_ACTIVE(TLL_DEBUG))
+      printSchedule();
     Job* missJob = NULL;
     while ( (missJob = (Job*)dlmon.check(now)) != NULL) {
       scheduleStat.cancelled.push_back((Job*)missJob);
@@ -90,11 +92,24 @@ namespace tmssim {
   }
 
 
+  TmsTime FPPNatScheduler::getNextEventTime(TmsTime now) const {
+    TmsTime next = ALDScheduler::getNextEventTime(now);
+    TmsTime check = dlmon.getNextCheckTime();
+    return (check < next) ? check : next;
+  }
+
+
   const std::string& FPPNatScheduler::getId(void) const {
     return myId;
   }
 
 
+  bool FPPNatScheduler::writeState(StateSnapshot& snapshot) const {
+    dlmon.writeState(snapshot);
+    return ALDScheduler::writeState(snapshot);
+  }
+
+
   Scheduler* FPPNatSchedulerAllocator() { return new FPPNatScheduler; }
 
 } // NS tmssim
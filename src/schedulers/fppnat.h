@@ -71,9 +71,19 @@ namespace tmssim {
 
     virtual Job* dispatch(TmsTime now, DispatchStat& dispatchStat);
 
+    /**
+     * Also regards the deadline monitoring performed in #schedule.
+     */
+    virtual TmsTime getNextEventTime(TmsTime now) const;
+
 
     virtual const std::string& getId(void) const;
 
+    /**
+     * Also writes the jobs of the own deadline monitor.
+     */
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
 
     
     
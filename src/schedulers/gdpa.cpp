@@ -29,6 +29,7 @@
  */
 
 #include <schedulers/gdpa.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 #include <utils/logger.h>
 
@@ -38,15 +39,26 @@ namespace tmssim {
 
   static const std::string myId = "GDPAScheduler";
 
+
+  static int distanceKey(const Job* job) {
+    return job->getTask()->getDistance();
+  }
+
   GDPAScheduler::GDPAScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : EDFScheduler(schedulerConfiguration), readyQueueChanged(false) {
+    : EDFScheduler(schedulerConfiguration, true), readyQueue(Job::QUEUE_READY),
+      readyQueueChanged(false) {
   }
 
 
   GDPAScheduler::~GDPAScheduler() {
     // ALDScheduler will cleanup the mySchedule list
     // BUT: not every job may be in this list!
-    mySchedule = readyQueue;
+    mySchedule.clear();
+    while (!readyQueue.empty()) {
+      Job* job = readyQueue.front();
+      readyQueue.pop_front();
+      mySchedule.push_back(job);
+    }
   }
 
 
@@ -59,6 +71,16 @@ namespace tmssim {
   }
 
 
+  void GDPAScheduler::enqueueJobs(const std::vector<Job*>& jobs) {
+    for (Job* job: jobs) {
+      assert(job->getTask() != NULL);
+      readyQueue.push_back(job);
+      jobEnqueued(job);
+    }
+    readyQueueChanged = true;
+  }
+
+
   bool GDPAScheduler::hasPendingJobs(void) const {
     return readyQueue.size() > 0;
   }
@@ -88,7 +110,7 @@ namespace tmssim {
   */
 
   int GDPAScheduler::schedule(__attribute__((unused)) TmsTime now, __attribute__((unused)) ScheduleStat& scheduleStat) {
-    list<Job*>::iterator it;
+    JobList::iterator it;
     // Check feasibility of all jobs
     // this is already done by ALDScheduler::initStep via the deadlinemonitor!
     /*
@@ -106,55 +128,61 @@ namespace tmssim {
     }
     */
     
-    // sort by shortest distance
-    list<Job*> sdfList;
-    for (it = readyQueue.begin();
-	 it != readyQueue.end(); ++it) {
-      Job* job = *it;
-      int distance = job->getTask()->getDistance();
-      list<Job*>::iterator ins = sdfList.begin();
-      while ( ins != sdfList.end()
-	      && *ins != NULL
-	      && (*ins)->getTask()->getDistance() <= distance ) {
-	ins++;
-      }
-      sdfList.insert(ins, job);
-    }
+    if (!readyQueueChanged)
+      return 0;
+
+    // sort by shortest distance, jobs with equal distance stay in
+    // the order of the ready queue
+    sortJobs(readyQueue.begin(), readyQueue.end(), distanceKey, sdfJobs);
     // create feasible EDF schedule
-    mySchedule.clear();
-    for (it = sdfList.begin(); it != sdfList.end(); it++) {
-      Job* job = *it;
-      std::list<Job*>::iterator ins = mySchedule.begin();
-      while ( ins != mySchedule.end()
-	      && *ins != NULL
-	      && (*ins)->getAbsDeadline() <= job->getAbsDeadline() ) {
-	ins++;
-      }
-      ins = mySchedule.insert(ins, job);
+    slackTree.clear();
+    for (size_t i = 0; i < sdfJobs.size(); ++i) {
+      Job* job = sdfJobs[i].job;
+      slackTree.insert(job);
       // now check feasibility
       const Job* fjob = checkEDFSchedule(now);
       if (fjob != NULL) {
-	mySchedule.erase(ins);
+	slackTree.remove(job);
       }
     }
+    slackTree.toList(mySchedule);
     readyQueueChanged = false;
     notifyScheduleChanged();
     return 0;
   }
 
 
+  TmsTime GDPAScheduler::getNextEventTime(TmsTime now) const {
+    if (readyQueueChanged)
+      return now + 1;
+    if (mySchedule.empty()) {
+      // only rejected jobs are left, they can only be cancelled
+      if (readyQueue.empty() || !myConfig.dlMissCancellations)
+	return TMS_TIME_MAX;
+      return dlmon.getNextCheckTime(NULL);
+    }
+    return EDFScheduler::getNextEventTime(now);
+  }
+
+
   const std::string& GDPAScheduler::getId(void) const {
     return myId;
   }
 
 
+  bool GDPAScheduler::writeState(StateSnapshot& snapshot) const {
+    snapshot.add(readyQueue.size());
+    for (const Job* job: readyQueue) {
+      snapshot.addJob(job);
+    }
+    snapshot.add(readyQueueChanged);
+    return EDFScheduler::writeState(snapshot);
+  }
+
+
   void GDPAScheduler::jobFinished(Job *job) {
-    list<Job*>::iterator it;
-    it = readyQueue.begin();
-    while (it != readyQueue.end() && *it != job)
-      ++it;
-    if (it != readyQueue.end()) { // found
-      readyQueue.erase(it);
+    if (readyQueue.remove(job)) { // found
+      readyQueueChanged = true;
     }
   }
 
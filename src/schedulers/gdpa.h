@@ -29,6 +29,8 @@
 
 #include <schedulers/edf.h>
 
+#include <vector>
+
 
 namespace tmssim {
 
@@ -45,6 +47,12 @@ namespace tmssim {
 
     virtual void enqueueJob(Job *job);
 
+    /**
+     * Appends the batch to the ready queue, which is only sorted when
+     * the schedule is rebuilt.
+     */
+    virtual void enqueueJobs(const std::vector<Job*>& jobs);
+
     virtual bool hasPendingJobs(void) const;
 
     //virtual int initStep(TmsTime now, ScheduleStat& scheduleStat);
@@ -53,20 +61,34 @@ namespace tmssim {
     /**
      * @brief This function calculates the actual GDPA schedule.
      *
-     * This method implements algorithm 1 from Cho et al. 2010
+     * This method implements algorithm 1 from Cho et al. 2010.
+     * The schedule is only rebuilt if a job was added, finished or
+     * cancelled since the last call, as only these events change the set
+     * of ready jobs or the (m,k) distances of the tasks. In all other time
+     * steps, the accepted jobs stay feasible and the rejected jobs stay
+     * infeasible, so the previous schedule is still valid.
      */
     virtual int schedule(TmsTime now, ScheduleStat& scheduleStat);
 
+    /**
+     * Steps can only be skipped while the schedule need not be rebuilt.
+     */
+    virtual TmsTime getNextEventTime(TmsTime now) const;
+
 
     virtual const std::string& getId(void) const;
 
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
   protected:
     virtual void jobFinished(Job *job);
 
 
   private:
-    std::list<Job*> readyQueue;
-    bool readyQueueChanged;
+    JobList readyQueue;
+    bool readyQueueChanged; ///< the schedule must be rebuilt
+    /// ready jobs sorted by distance, kept to avoid reallocation
+    std::vector< KeyedJob<int> > sdfJobs;
   };
 
 
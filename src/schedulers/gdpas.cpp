@@ -42,21 +42,27 @@ namespace tmssim {
   static const std::string myId = "GDPA-SScheduler";
 
 
+  static int distanceKey(const Job* job) {
+    return job->getTask()->getDistance();
+  }
+
+
   GDPASScheduler::GDPASScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : Scheduler(), myConfig(schedulerConfiguration), /*readyListChanged(false),*/
+    : Scheduler(), myConfig(schedulerConfiguration), readyList(Job::QUEUE_READY),
+      sdfList(Job::QUEUE_SCHEDULE), /*readyListChanged(false),*/
       dispatchListsChanged(false), /*edfFeasible(false),*/ currentJob(NULL) {
 
   }
 
 
   GDPASScheduler::~GDPASScheduler() {
-    list<Job*>::iterator it = readyList.begin();
-    while (it != readyList.end()) {
-      Job* job = *it;
+    sdfList.clear();
+    while (!readyList.empty()) {
+      Job* job = readyList.front();
+      readyList.pop_front();
       tWarn() << "ALDScheduler destroys unfinished job " << *job;
       //<< " in instance of " << getId();
       delete job;
-      it = readyList.erase(it);
     }
   }
 
@@ -70,7 +76,7 @@ namespace tmssim {
     //readyListChanged = true;
 
     int distance = job->getTask()->getDistance();
-    list<Job*>::iterator insSDF = sdfList.begin();
+    JobList::iterator insSDF = sdfList.begin();
     while ( insSDF != sdfList.end()
 	    && *insSDF != NULL
 	    && (*insSDF)->getTask()->getDistance() <= distance ) {
@@ -78,21 +84,39 @@ namespace tmssim {
     }
     sdfList.insert(insSDF, job);
 
-    //Job* job = *it;
-    std::list<Job*>::iterator insEDF = edfList.begin();
-    while ( insEDF != edfList.end()
-	    && *insEDF != NULL
-	    && (*insEDF)->getAbsDeadline() <= job->getAbsDeadline() ) {
-      insEDF++;
+    edfList.insert(job);
+    dispatchListsChanged = true;
+  }
+
+
+  void GDPASScheduler::enqueueJobs(const std::vector<Job*>& jobs) {
+    for (Job* job: jobs) {
+      assert(job != NULL);
+      assert(job->getTask() != NULL);
+      readyList.push_back(job);
+      edfList.insert(job);
+    }
+    // sort by distance, jobs with equal distances stay in the order of
+    // the batch
+    sortJobs(jobs.begin(), jobs.end(), distanceKey, batchJobs);
+    // same position as in enqueueJob: behind all jobs with the same
+    // distance, so the merge can continue behind the previous job
+    JobList::iterator insSDF = sdfList.begin();
+    for (size_t i = 0; i < batchJobs.size(); ++i) {
+      while ( insSDF != sdfList.end()
+	      && *insSDF != NULL
+	      && (*insSDF)->getTask()->getDistance() <= batchJobs[i].key ) {
+	insSDF++;
+      }
+      sdfList.insert(insSDF, batchJobs[i].job);
     }
-    edfList.insert(insEDF, job);
     dispatchListsChanged = true;
   }
 
 
   int GDPASScheduler::initStep(TmsTime now, ScheduleStat& scheduleStat) {
     // lines 14-18
-    list<Job*>::iterator it = readyList.begin();
+    JobList::iterator it = readyList.begin();
     while (it != readyList.end()) {
       LOG(LOG_CLASS_SCHEDULER) << "Checking job...";
       if ( !(*it)->isFeasible(now) //(*it)->getLatestStartTime() < now
@@ -100,8 +124,8 @@ namespace tmssim {
 	       || (*it)->getRemainingExecutionTime() == (*it)->getExecutionTime()) ) {
 	Job* job = *it;
 	it = readyList.erase(it);
-	removeJobFromList(edfList, job);
-	removeJobFromList(sdfList, job);
+	edfList.remove(job);
+	sdfList.remove(job);
 	scheduleStat.cancelled.push_back(job);
 	if (currentJob == job)
 	  currentJob = NULL;
@@ -163,7 +187,7 @@ namespace tmssim {
     bool edfFeasible = false;
     if (currentJob == NULL || dispatchListsChanged) {
       // lines 19-23
-      edfFeasible = EDFScheduler::checkEDFSchedule(now, edfList) == NULL;
+      edfFeasible = edfList.firstMiss(now) == NULL;
       //currentJob = edfFeasible ? edfList.front() : sdfList.front();
       if (readyList.size() > 0) {
 	if (edfFeasible) {
@@ -201,6 +225,7 @@ namespace tmssim {
       return finishedJob;
     }
     else {
+      edfList.update(currentJob);
       return NULL;
     }
   }
@@ -213,9 +238,9 @@ namespace tmssim {
 
   void GDPASScheduler::jobFinished(Job *job) {
     // lines 9-12
-    removeJobFromList(readyList, job);
-    removeJobFromList(edfList, job);
-    removeJobFromList(sdfList, job);
+    readyList.remove(job);
+    edfList.remove(job);
+    sdfList.remove(job);
     //readyListChanged = true;
     dispatchListsChanged = true;
     //feasibilityCheck();
@@ -238,16 +263,6 @@ namespace tmssim {
     */
   }
 
-  void GDPASScheduler::removeJobFromList(list<Job*>& jList, Job* job) {
-    list<Job*>::iterator it = jList.begin();
-    while (it != jList.end() && *it != job)
-      it++;
-    if (it != jList.end()) {
-      jList.erase(it);
-    }
-  }
-
-
   Scheduler* GDPASSchedulerAllocator(const SchedulerConfiguration& schedulerConfiguration) { return new GDPASScheduler(schedulerConfiguration); }
 
 } // NS tmssim
@@ -28,6 +28,11 @@
 #define SCHEDULERS_GDPAS_H 1
 
 #include <core/scheduler.h>
+#include <core/edfslacktree.h>
+#include <core/joblist.h>
+#include <core/jobsort.h>
+
+#include <vector>
 
 namespace tmssim {
 
@@ -43,6 +48,13 @@ namespace tmssim {
     virtual ~GDPASScheduler();
 
     virtual void enqueueJob(Job *job);
+
+    /**
+     * Sorts the batch by distance and merges it into #sdfList in a
+     * single pass.
+     */
+    virtual void enqueueJobs(const std::vector<Job*>& jobs);
+
     virtual const Job* removeJob(const Job *job);
 
     virtual bool hasPendingJobs(void) const;
@@ -73,10 +85,11 @@ namespace tmssim {
 
   private:
     void feasibilityCheck(TmsTime now);
-    void removeJobFromList(std::list<Job*>& jList, Job* job);
-    std::list<Job*> readyList;
-    std::list<Job*> sdfList;
-    std::list<Job*> edfList;
+    JobList readyList;
+    JobList sdfList;
+    EdfSlackTree edfList; ///< ready jobs in EDF order
+    /// Jobs of the current #enqueueJobs call, sorted by distance
+    std::vector< KeyedJob<int> > batchJobs;
     //bool readyListChanged;
     bool dispatchListsChanged;
     //bool queuesChanged;
@@ -38,7 +38,7 @@ namespace tmssim {
   
   
   OEDFScheduler::OEDFScheduler(const SchedulerConfiguration& schedulerConfiguration)
-    : EDFScheduler(schedulerConfiguration) {
+    : EDFScheduler(schedulerConfiguration, true) {
   }
   
   
@@ -50,31 +50,54 @@ namespace tmssim {
 			      __attribute__((unused)) ScheduleStat& scheduleStat) {
     const Job* missJob;
     const Job* lastFoundJob = NULL;
+    valueCache.clear();
     while ( (missJob = checkEDFSchedule(now)) != NULL
 	    && missJob != lastFoundJob) {
       LOG(LOG_CLASS_SCHEDULER) << "Found DL-Miss job " << *missJob
 			       << " (now=" << now << ")";
-      list<Job*>::iterator current;
+      JobList::iterator current = mySchedule.end();
       double currentVal = getComparisonNeutral();
       TmsTime time = now; // FIXME: evolve???
-      list<Job*>::iterator it;
+      JobList::iterator it;
+      size_t pos = 0;
       // search in jobs scheduled before missJob
       for (it = mySchedule.begin();
-	   it != mySchedule.end() && *it != missJob; ++it) {
+	   it != mySchedule.end() && *it != missJob; ++it, ++pos) {
 	Job* job = *it;
+	if (pos < valueCache.size()
+	    && valueCache[pos].job == job && valueCache[pos].time == time) {
+	  // same job at the same start time as in the previous search
+	  const ValueEntry& entry = valueCache[pos];
+	  LOG(LOG_CLASS_SCHEDULER) << "\tChecking " << *job << " with value "
+				   << entry.value << " (now=" << now << ")";
+	  if (entry.newCandidate) {
+	    LOG(LOG_CLASS_SCHEDULER) << "New candidate utility found: "
+				     << entry.value << " << @ job " << *job
+				     << " (now=" << now << ")";
+	  }
+	  current = entry.candidate;
+	  currentVal = entry.candidateValue;
+	  time += job->getExecutionTime();
+	  continue;
+	}
+	valueCache.resize(pos);
+
 	double val = calcValue(time, job);
+	ValueEntry entry = { job, time, val, false, current, currentVal };
 	time += job->getExecutionTime();
 	LOG(LOG_CLASS_SCHEDULER) << "\tChecking " << *job << " with value "
 				 << val << " (now=" << now << ")";
-	if (!isCancelCandidate(job, val))
-	  continue;
-	if (compare(currentVal, val)) {
+	if (isCancelCandidate(job, val) && compare(currentVal, val)) {
 	  current = it;
 	  currentVal = val;
+	  entry.newCandidate = true;
+	  entry.candidate = current;
+	  entry.candidateValue = currentVal;
 	  LOG(LOG_CLASS_SCHEDULER) << "New candidate utility found: " << val
 				   << " << @ job " << *job << " (now=" << now
 				   << ")";
 	}
+	valueCache.push_back(entry);
       }
       if (*it == missJob) {
 	// So far no cancidate was found - check if we can remove missJob
@@ -100,6 +123,15 @@ namespace tmssim {
   }
 
 
+  TmsTime OEDFScheduler::getNextEventTime(TmsTime now) const {
+    // executing the first job does not change the feasibility of the schedule
+    if (checkEDFSchedule(now + 1) != NULL)
+      return now + 1;
+    else
+      return EDFScheduler::getNextEventTime(now);
+  }
+
+
   bool OEDFScheduler::isCancelCandidate(const Job* job, __attribute__((unused)) double value) const {
     if ( !myConfig.execCancellations &&
 	 job->getRemainingExecutionTime() < job->getExecutionTime() ) {
@@ -38,6 +38,12 @@ namespace tmssim {
     virtual ~OEDFScheduler();
     virtual int schedule(TmsTime now, ScheduleStat& scheduleStat);
 
+    /**
+     * As long as the EDF schedule stays infeasible, #schedule must be
+     * called in every time step.
+     */
+    virtual TmsTime getNextEventTime(TmsTime now) const;
+
     // concrete subclasses need to re-implement this method!
     virtual const std::string& getId(void) const = 0;
 
@@ -77,6 +83,32 @@ namespace tmssim {
      * @return true, if the candidate can be cancelled
      */
     virtual bool isCancelCandidate(const Job* job, double value) const;
+
+  private:
+    /**
+     * Value of a job ahead of the current miss job. The entries follow
+     * the order of ALDScheduler::mySchedule and are only valid during
+     * one call of #schedule, as the job and task histories do not
+     * change before the cancellations are performed by the simulation.
+     */
+    struct ValueEntry {
+      const Job* job;
+      /// start time that was passed to #calcValue
+      TmsTime time;
+      double value;
+      /// the job became the new cancellation candidate
+      bool newCandidate;
+      /// best cancellation candidate up to and including this job
+      JobList::iterator candidate;
+      double candidateValue;
+    };
+
+    /**
+     * Values from the previous search for the same tick. A cancellation
+     * only shifts the start times of the jobs behind the cancelled one,
+     * so the next search reuses the entries in front of it.
+     */
+    std::vector<ValueEntry> valueCache;
   };
   
 
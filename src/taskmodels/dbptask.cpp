@@ -70,7 +70,7 @@ namespace tmssim {
 
   Job* DbpTask::spawnHook(TmsTime now) {
     TmsPriority dbPriority = getDistance();
-    Job* job = new Job(this, activations, now, executionTime, now + relDeadline, dbPriority);
+    Job* job = new Job(this, getActivations(), now, executionTime, now + relDeadline, dbPriority);
     tDebug() << "Created dbpjob " << *job << " taskprio " << dbPriority;
     return job;
 
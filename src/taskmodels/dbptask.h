@@ -77,6 +77,9 @@ namespace tmssim {
      * @}
      */
 
+    /// statically bound hook calls, see Task::spawnJobAs
+    friend class Task;
+
   protected:
     virtual Job* spawnHook(TmsTime now);
     virtual bool completionHook(Job *job, TmsTime now);
@@ -29,8 +29,9 @@
  */
 
 #include <taskmodels/mkmonitor.h>
+#include <core/steadystate.h>
+#include <utils/bitstrings.h>
 
-#include <cassert>
 #include <sstream>
 
 using namespace std;
@@ -38,125 +39,65 @@ using namespace std;
 namespace tmssim {
 
   MkMonitor::MkMonitor(unsigned int _m, unsigned int _k, CompressedMkState _is /*, unsigned int _init*/)
-    : m(_m), k(_k), pos(0), recorded(0), violations(0)
+    : m(_m), k(_k), window(0), recorded(0), violations(0)
       // Initialise recorded with 1 to avoid additions during comparisons
   {
-    assert(k < 64);
-    //unsigned int _init = 1;
-    vals = new unsigned int[k];
-    sum = 0;
+    if (k >= CMKS_MAX_SIZE) {
+      ostringstream oss;
+      oss << "State for k=" << k << " cannot be fit into CompressedMkState";
+      throw MkMonitor::MkMonitorException(oss.str());
+    }
+    mask = (1ULL << k) - 1;
+    // _is lists the jobs from least to most recent
     for (unsigned int i = 0; i < k; ++i) {
-      unsigned iv = (_is >> i) & 1;
-      vals[i] = iv;
-      sum += iv;
+      window = (window << 1) | ((_is >> i) & 1);
     }
   }
 
 
   MkMonitor::~MkMonitor() {
-    delete[] vals;
   }
 
 
   void MkMonitor::push(unsigned int _val) {
-    unsigned int tmp = vals[pos];
-    vals[pos] = _val;
-    sum -= tmp;
-    sum += _val;
-    ++pos;
-    if (pos >= k)
-      pos = 0;
+    window = ((window << 1) | (_val & 1)) & mask;
     ++recorded;
     if (recorded >= k) { // recorded == k <=> the newest value was the k-th one
-      if (sum < m)
+      if (countBits(window) < m)
 	++violations;
     }
-    assert(pos < k);
   }
 
 
   unsigned int MkMonitor::getCurrentSum() const {
     if (recorded < k) {
       // this is more tricky than it seems - we need to check wether the task
-      // may still keep its constraints
+      // may still keep its constraints: ignore the initial values and
+      // assume the missing ones were successful
       unsigned int missing = k - recorded; // how many values/jobs are missing for full window?
-      unsigned int ctr = 0;
-      unsigned int psum = sum;
-      size_t ppos = pos;
-      while (ctr < missing) {
-	psum -= vals[ppos];
-	++ppos;
-	if (ppos >= k)
-	  ppos = 0;
-	++ctr;
-      }
-      psum += missing;
-      return psum;
+      return countBits(window & ((1ULL << recorded) - 1)) + missing;
     }
     else {
-      return sum;
+      return countBits(window);
     }
   }
 
 
-  const unsigned int* MkMonitor::getVals() const {
-    return vals;
-  }
-
-
-  size_t MkMonitor::getPos() const {
-    return pos;
-  }
-
-
   unsigned int MkMonitor::getViolations() const {
     return violations;
   }
 
 
   string MkMonitor::printState() const {
-    ostringstream oss;
-    for (size_t i = 0; i < k; ++i) {
-      size_t p = (pos + i) % k;
-      oss << vals[p];
-    }
-    return oss.str();
+    return strBitString(window, k);
   }
 
 
-  CompressedMkState MkMonitor::getState() const {
-    if (k > CMKS_MAX_SIZE) {
-      ostringstream oss;
-      oss << "State for k=" << k << " cannot be fit into CompressedMkState";
-      throw MkMonitor::MkMonitorException(oss.str());
-    }
-    CompressedMkState cstate = 0;
-    for (size_t i = 0; i < k; ++i) {
-      size_t p = (pos + i) % k;
-      //cstate |= vals[p] << i;
-      cstate <<= 1;
-      cstate |= vals[p] & 0x1;
-    }
-    return cstate;
-  }
-
   CompressedMkState MkMonitor::getReducedState() const {
-    if (k > CMKS_MAX_SIZE) {
-      ostringstream oss;
-      oss << "State for k=" << k << " cannot be fit into CompressedMkState";
-      throw MkMonitor::MkMonitorException(oss.str());
-    }
-    CompressedMkState cstate = 0;
-    for (size_t i = 1; i < k; ++i) {
-      size_t p = (pos + i) % k;
-      //cstate |= vals[p] << i;
-      cstate <<= 1;
-      cstate |= vals[p] & 0x1;
-    }
-    return cstate;
+    return window & (mask >> 1);
   }
 
-  
+
   bool MkMonitor::isStateValid() const {
     /*
     if (recorded < k)
@@ -168,4 +109,17 @@ namespace tmssim {
     return getCurrentSum() >= m;
   }
 
+
+  void MkMonitor::writeState(StateSnapshot& snapshot) const {
+    snapshot.add(window);
+    // only the first k values are treated differently
+    snapshot.add(recorded < k ? recorded : k);
+  }
+
+
+  void MkMonitor::visitCounters(CounterVisitor& visitor) {
+    visitor.visit(recorded);
+    visitor.visit(violations);
+  }
+
 } // NS tmssim
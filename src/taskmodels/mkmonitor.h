@@ -32,6 +32,9 @@
 
 namespace tmssim {
 
+  class CounterVisitor;
+  class StateSnapshot;
+
   /**
    * @brief Compressed representation of a task's current (m,k)-state.
    *
@@ -46,8 +49,9 @@ namespace tmssim {
   /**
    * @brief Monitoring of (m,k) constraint.
    *
-   * This class implements a ring buffer to monitor the a sliding window
-   * of \f$k\f$ job executions.
+   * This class implements a shift register to monitor the a sliding window
+   * of \f$k\f$ job executions. The window is stored in the same layout as
+   * CompressedMkState, i.e. the LSB represents the most recent job.
    *
    * @todo add check for (m,k) constraint, actually use m
    */
@@ -57,8 +61,10 @@ namespace tmssim {
      * @brief C'tor
      *
      * @param _m \f$m\f$ of the (m,k) constraint (currently not used!)
-     * @param _k \f$k\f$ of the (m,k) constraint
-     * @param _is initial (m,k) state
+     * @param _k \f$k\f$ of the (m,k) constraint, must be smaller than
+     *           #CMKS_MAX_SIZE
+     * @param _is initial (m,k) state; bit 0 is the least recent job,
+     *            bit k-1 the most recent one
      */
     MkMonitor(unsigned int _m, unsigned int _k, CompressedMkState _is = CMKS_ALL_SUCCESS);
     /**
@@ -86,23 +92,6 @@ namespace tmssim {
      */
     unsigned int getCurrentSum() const;
 
-    /**
-     * @brief Get the complete buffer.
-     *
-     * Note: the returned array is not ordered! Use the getPos() method
-     * to get the position of the oldest entry. The most recent entry is
-     * located at \f$p-1 (\% k)\f$. The least recent entry is at \f$p\f$.
-     * @return the complete buffer
-     */
-    const unsigned int* getVals() const;
-
-    /**
-     * @brief Get the position of the oldest entry in the buffer.
-     *
-     * @return position
-     */
-    size_t getPos() const;
-
     /**
      * @brief Get the number of violations of the (m,k)-constraint
      * @return the number
@@ -112,13 +101,27 @@ namespace tmssim {
     std::string printState() const;
 
     /**
-     *
+     * @brief Get the current window, O(1)
+     */
+    CompressedMkState getState() const { return window; }
+
+    /**
+     * @brief Get the current window without the least recent job
      */
-    CompressedMkState getState() const;
     CompressedMkState getReducedState() const;
 
     bool isStateValid() const;
 
+    /**
+     * @brief Write the window for steady-state detection
+     */
+    void writeState(StateSnapshot& snapshot) const;
+
+    /**
+     * @brief Visit the number of recorded values and of violations
+     */
+    void visitCounters(CounterVisitor& visitor);
+
     class MkMonitorException {
     public:
       MkMonitorException(std::string _msg = "")
@@ -132,20 +135,11 @@ namespace tmssim {
     unsigned int m;
     unsigned int k;
     /**
-     * Points to next write field in buffer
-     */
-    size_t pos;
-
-    /**
-     * Ring buffer
+     * Window of the last k jobs, LSB is the most recent one
      */
-    unsigned int* vals;
+    CompressedMkState window;
 
-    /**
-     * Current sum of the values that are in the buffer. This value is
-     * updated any time the buffer is changed by the push() method.
-     */
-    unsigned int sum;
+    CompressedMkState mask; ///< the lower k bits
 
     unsigned int recorded; ///!< number of the <b>next</b> value that is recorded
     
@@ -29,6 +29,7 @@
  */
 
 #include <taskmodels/mkptask.h>
+#include <core/steadystate.h>
 #include <utils/tlogger.h>
 #include <xmlio/xmlutils.h>
 #include <cmath>
@@ -90,13 +91,14 @@ namespace tmssim {
 
 
   /**
-   * we can use the activations field of the Task class instead of keeping
+   * we can use the activation counter of the Task class instead of keeping
    * another counter a
    */
   Job* MkpTask::spawnHook(TmsTime now) {
     int _prio;
     //double tmp = floor(ceil( (double)(activations + actSpin) * (double)m / (double)k) * (double)k / (double)m);
     //if (int(tmp) == activations) { // mandatory
+    const int activations = getActivations();
     if (isJobMandatory(activations)) {
       _prio = priority;
     }
@@ -120,6 +122,13 @@ namespace tmssim {
   }
 
 
+  bool MkpTask::writeState(StateSnapshot& snapshot) const {
+    // the pattern of mandatory jobs repeats every k activations
+    snapshot.add(getActivations() % k);
+    return MkTask::writeState(snapshot);
+  }
+
+
   void MkpTask::enableSpin() {
     actSpin = spin;
     //cmpAdd = 1;
@@ -72,6 +72,8 @@ namespace tmssim {
 
     bool isJobMandatory(unsigned int jobId) const;
 
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
     void enableSpin();
     void disableSpin();
 
@@ -88,6 +90,9 @@ namespace tmssim {
      * @}
      */
 
+    /// statically bound hook calls, see Task::spawnJobAs
+    friend class Task;
+
   protected:
     virtual Job* spawnHook(TmsTime now);
     virtual bool completionHook(Job *job, TmsTime now);
@@ -29,8 +29,10 @@
  */
 
 #include <taskmodels/mktask.h>
+#include <core/steadystate.h>
 #include <utils/logger.h>
 #include <utils/tlogger.h>
+#include <utils/bitstrings.h>
 
 #include <cassert>
 
@@ -91,8 +93,6 @@ namespace tmssim {
 
 
   int MkTask::getDistance() const {
-    /*const unsigned int* vals = monitor.getVals();
-      unsigned int pos = monitor.getPos();*/
     int l = calcL(m);
     assert(l >= 0);
     int distance = k - l + 1;
@@ -100,36 +100,29 @@ namespace tmssim {
   }
 
 
-  int MkTask::calcL(unsigned int n, const unsigned int* vals, unsigned int pos) const {
+  int MkTask::calcL(unsigned int n, CompressedMkState state) const {
     if (n > k) {
       tError() << "Invalid parameter n=" << n << " > " << k << "!";
       return -1;
     }
-    unsigned int p;
-    if (pos == 0)
-      p = k - 1;
-    else
-      p = pos - 1;
-
-    unsigned int ctr = 0;
-    unsigned int i;
-    for (i = 0; i < k; ++i) {
-      if (vals[p] == 1)
-	ctr++;
-      if (ctr == n)
-	break;
-
-      if (p == 0)
-	p = k - 1;
-      else
-	--p;
+    if (n == 0) {
+      // the 0th meet is found before the first meet
+      return (state & 1) ? k + 1 : 1;
     }
-    return i + 1;
+    // LSB is the most recent job
+    unsigned int p = selectBit(state, n);
+    return p < k ? p + 1 : k + 1;
   }
 
 
   int MkTask::calcL(int n) const {
-    return calcL(n, monitor.getVals(), monitor.getPos());
+    return calcL(n, monitor.getState());
+  }
+
+
+  TmsTime MkTask::startHook(TmsTime now) {
+    reserveDelayCounters(k);
+    return PeriodicTask::startHook(now);
   }
 
 
@@ -169,6 +162,18 @@ namespace tmssim {
   }
 
 
+  bool MkTask::writeState(StateSnapshot& snapshot) const {
+    monitor.writeState(snapshot);
+    return PeriodicTask::writeState(snapshot);
+  }
+
+
+  void MkTask::visitCounters(CounterVisitor& visitor) {
+    PeriodicTask::visitCounters(visitor);
+    monitor.visitCounters(visitor);
+  }
+
+
   std::ostream& MkTask::print(std::ostream& ost) const {
     PeriodicTask::print(ost);
     ost << " (" << m << "," << k << ") spin=" << spin << " mkstate = " << monitor.printState();
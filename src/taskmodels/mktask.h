@@ -92,12 +92,11 @@ namespace tmssim {
      * Implements function \f$l_j(n,s)\f$ from Hamdaoui & Ramanathan (1995).
      *
      * @param n which deadline meet should be found
-     * @param vals ring buffer length k
-     * @param pos current head of buffer
+     * @param state (m,k) state, see MkMonitor::getState
      * @return a number between 1 and k, k+1 if no nth meet exists,
      *         and -1 if n>k
      */
-    int calcL(unsigned int n, const unsigned int* vals, unsigned int pos) const;
+    int calcL(unsigned int n, CompressedMkState state) const;
 
 
     /**
@@ -115,6 +114,9 @@ namespace tmssim {
      */
     const MkMonitor& getMonitor() const;
 
+    virtual bool writeState(StateSnapshot& snapshot) const;
+    virtual void visitCounters(CounterVisitor& visitor);
+
 
     /**
      * @name XML
@@ -133,7 +135,17 @@ namespace tmssim {
 
     virtual std::string strState() const;
 
+    /// statically bound hook calls, see Task::spawnJobAs
+    friend class Task;
+
   protected:
+    /**
+     * Reserves the delay counters for runs of up to k misses, more would
+     * violate the (m,k)-constraint anyway. If you overwrite this function
+     * in your implementation, make sure to still call it!
+     */
+    virtual TmsTime startHook(TmsTime now);
+
     /**
      * If you overwrite this function in your implementation, make sure to
      * still call it!
@@ -29,6 +29,7 @@
  */
 
 #include <taskmodels/periodictask.h>
+#include <core/steadystate.h>
 #include <xmlio/xmlutils.h>
 
 #include <iostream>
@@ -59,7 +60,7 @@ namespace tmssim {
   
   
   Job* PeriodicTask::spawnHook(TmsTime now) {
-    return new Job(this, activations, now, executionTime, now + relDeadline, getPriority());
+    return new Job(this, getActivations(), now, executionTime, now + relDeadline, getPriority());
   }
   
   
@@ -99,6 +100,18 @@ namespace tmssim {
   double PeriodicTask::getHistoryValue(void) const {
     return historyUtility;
   }
+
+
+  bool PeriodicTask::writeState(StateSnapshot& snapshot) const {
+    snapshot.addValue(lastUtility);
+    snapshot.addValue(historyUtility);
+    return writeTaskState(snapshot);
+  }
+
+
+  TmsTimeInterval PeriodicTask::getActivationPeriod() const {
+    return period;
+  }
   
   
   double PeriodicTask::calcExecValue(const Job *job, TmsTime complTime) const {
@@ -43,6 +43,9 @@ namespace tmssim {
     
     virtual double getLastExecValue(void) const;
     virtual double getHistoryValue(void) const;
+
+    virtual bool writeState(StateSnapshot& snapshot) const;
+    virtual TmsTimeInterval getActivationPeriod() const;
     
     
     /**
@@ -83,7 +83,7 @@ namespace tmssim {
   
 
   Job* SporadicTask::spawnHook(TmsTime now) {
-    return new Job(this, activations, now, executionTime, now + relDeadline, getPriority());
+    return new Job(this, getActivations(), now, executionTime, now + relDeadline, getPriority());
   }
   
   
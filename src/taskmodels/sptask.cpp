@@ -81,7 +81,7 @@ namespace tmssim {
   
   
   Job* SPTask::spawnHook(TmsTime now) {
-    return new Job(this, activations, now, executionTime, now + relDeadline, getPriority());
+    return new Job(this, getActivations(), now, executionTime, now + relDeadline, getPriority());
   }
   
   
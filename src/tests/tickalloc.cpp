@@ -0,0 +1,85 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the copyright holder.
+ */
+
+/**
+ * $Id$
+ * @file tickalloc.cpp
+ * @brief Check that simulation steps do not allocate heap memory
+ *
+ * Only built with -DCOUNT_ALLOCATIONS=1. Simulates some random (m,k)
+ * task sets with all mkeval allocators and reports each simulation in
+ * which time steps after the warm-up allocated memory. The check fails
+ * if any simulation allocates after the warm-up.
+ */
+
+#include <mkeval/mkallocators.h>
+#include <mkeval/mkgenerator.h>
+#include <mkeval/mkglobals.h>
+#include <utils/allocationcounter.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tmssim;
+
+static const unsigned int N_TASKSETS = 20;
+static const TmsTimeInterval STEPS = 5000;
+
+
+int main() {
+  if (!AllocationCounter::isEnabled()) {
+    cerr << "tms-sim was built without COUNT_ALLOCATIONS" << endl;
+    return 2;
+  }
+
+  const MkAllocators& mka = MkAllocators::instance();
+  const list<string> ids = mka.listAllocators();
+  MkGenerator generator(42, 5, 5, 15, 2, 10, 0.9);
+  unsigned int failures = 0;
+
+  for (unsigned int i = 0; i < N_TASKSETS; ++i) {
+    MkTaskset* mkts = generator.nextTaskset();
+    for (const string& id: ids) {
+      const MkEvalAllocatorPair* pair = mka.getAllocatorPair(id);
+      Taskset* ts = new Taskset;
+      for (MkTask* mt: mkts->tasks) {
+	ts->push_back(pair->taskAlloc(mt));
+      }
+      Simulation* sim = mka.newSimulation(ts, pair->schedAlloc(DefaultSchedulerConfiguration));
+      sim->run(STEPS);
+      if (sim->getAllocatingSteps() > 0) {
+	cout << id << " on task set " << mkts->seed << ": "
+	     << sim->getAllocatingSteps() << " allocating steps" << endl;
+	++failures;
+      }
+      delete sim;
+    }
+    delete mkts;
+  }
+
+  cout << failures << " simulation(s) allocated memory after the warm-up"
+       << endl;
+  return failures > 0 ? 1 : 0;
+}
@@ -220,6 +220,9 @@ void initialiseProgramOptions() {
 - [m]kuedf\n\
 - [p]hcedf")
     (",l", po::value<vector<string>>(&poLog), "Activate execution logs, for valid options see below")
+    ("event-driven,E", "Skip simulation steps without events (faster, condensed EXEC log)")
+    ("steady-state,P", "Skip repetitions of a periodic steady state (same results, not with EXEC/SIM/TASK/SCHED logs)")
+    ("heap-queue,Q", "Keep ready jobs in a heap instead of a sorted list (EDF only)")
     ;
 }
 
@@ -232,6 +235,9 @@ bool initialise(vector<Task*>& taskset) {
   bool success = true;
 
   // Schedulers
+  if (vm.count("heap-queue")) {
+    DefaultSchedulerConfiguration.heapReadyQueue = true;
+  }
   const char* str = poSchedulers.c_str();
   while (*str != '\0') {
     switch (*str) {
@@ -266,6 +272,14 @@ bool initialise(vector<Task*>& taskset) {
     str++;
   }
 
+  // Time advance
+  if (vm.count("event-driven")) {
+    Simulation::setDefaultAdvanceMode(Simulation::AM_EVENT);
+  }
+  if (vm.count("steady-state")) {
+    Simulation::setDefaultSteadyStateDetection(true);
+  }
+
   // Logger
   for (string logClass: poLog) {
     logger::activateClass(logClass);
@@ -151,6 +151,11 @@ namespace tmssim {
   }
 
 
+  bool PConsumerTask::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
+
+
   std::ostream& PConsumerTask::print(std::ostream& ost) const {
     ost << getIdString() << ": " << getExecutionTime() << " / "
 	<< getPeriod() << " / "  << getResponseTime() << " [ ";
@@ -292,7 +297,7 @@ namespace tmssim {
 
   
   Job* PConsumerTask::spawnHook(TmsTime now) {
-    return new PConsumerTask::PConsumerJob(this, activations, now, executionTime, now + relDeadline, getPriority(), nProducers, producers);
+    return new PConsumerTask::PConsumerJob(this, getActivations(), now, executionTime, now + relDeadline, getPriority(), nProducers, producers);
   }
 
 
@@ -133,6 +133,9 @@ namespace tmssim {
      */
     virtual std::ostream& print(std::ostream& ost) const;
 
+    /// Not supported, the collected ages and statistics grow with every job
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
     virtual std::string getPrintableData() const;
 
     void calculateStatistics();
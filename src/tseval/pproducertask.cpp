@@ -106,6 +106,11 @@ namespace tmssim {
   }
 
 
+  bool PProducerTask::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
+
+
   std::ostream& PProducerTask::print(std::ostream& ost) const {
     ost << getIdString() << ": " << getExecutionTime() << " / "
 	<< getPeriod() << " / "  << getResponseTime();
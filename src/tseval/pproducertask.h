@@ -138,6 +138,9 @@ namespace tmssim {
     virtual TmsTimeElement getData(const std::string& type, TmsTime time) const;
 
     virtual std::ostream& print(std::ostream& ost) const;
+
+    /// Not supported, the data buffers depend on the absolute time
+    virtual bool writeState(StateSnapshot& snapshot) const;
     
   protected:
     //virtual Job* spawnHook(int now);
@@ -60,6 +60,11 @@ namespace tmssim {
   }
 
   
+  bool TmpPConsumerTask::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return false;
+  }
+
+
   std::ostream& TmpPConsumerTask::print(std::ostream& ost) const {
     ost << getIdString() << ": " << getExecutionTime() << " / "
 	<< getPeriod() << " / "  << getResponseTime() << " [ ";
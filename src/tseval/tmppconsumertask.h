@@ -60,6 +60,9 @@ namespace tmssim {
      */
     virtual std::ostream& print(std::ostream& ost) const;
 
+    /// Not supported, the task is not implemented yet
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
   protected:
     virtual Job* spawnHook(TmsTime now);
     virtual bool completionHook(Job *job, TmsTime now);
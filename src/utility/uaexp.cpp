@@ -29,6 +29,7 @@
  */
 
 #include <utility/uaexp.h>
+#include <core/steadystate.h>
 #include <xmlio/xmlutils.h>
 
 namespace tmssim {
@@ -92,4 +93,10 @@ namespace tmssim {
     return 0;
   }
   
+  bool UAExp::writeState(StateSnapshot& snapshot) const {
+    snapshot.addValue(currentValue);
+    return true;
+  }
+
+
 } // NS tmssim
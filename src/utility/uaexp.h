@@ -60,6 +60,8 @@ namespace tmssim {
      * @return A pointer to a new object with the same properties of this object
      */
     virtual UtilityAggregator* clone() const;
+
+    virtual bool writeState(StateSnapshot& snapshot) const;
     
 
     /**
@@ -29,6 +29,7 @@
  */
 
 #include <utility/uamean.h>
+#include <core/steadystate.h>
 
 namespace tmssim {
 
@@ -80,5 +81,11 @@ namespace tmssim {
   }
 
 
+  bool UAMean::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    // the mean only depends on the counters
+    return true;
+  }
+
+
 } // NS tmssim
 
@@ -6,6 +6,7 @@
  */
 
 #include <utility/uanone.h>
+#include <core/steadystate.h>
 
 #include <utils/tmsexception.h>
 
@@ -53,4 +54,9 @@ namespace tmssim {
   }
   
 
+  bool UANone::writeState(__attribute__((unused)) StateSnapshot& snapshot) const {
+    return true;
+  }
+
+
 } // NS tmssim
@@ -34,6 +34,8 @@ namespace tmssim {
      */
     virtual UtilityAggregator* clone() const;
 
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
         /**
      * @name XML
      * @{
@@ -29,6 +29,7 @@
  */
 
 #include <utility/uawindow.h>
+#include <core/steadystate.h>
 
 #include <utils/tlogger.h>
 
@@ -89,4 +90,13 @@ namespace tmssim {
     return UtilityAggregator::writeData(writer);
   }
 
+  bool UAWindow::writeState(StateSnapshot& snapshot) const {
+    snapshot.add(size);
+    for (size_t i = 0; i < size; ++i) {
+      snapshot.addValue((*this)[i]);
+    }
+    return true;
+  }
+
+
 } // NS tmssim
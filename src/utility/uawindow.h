@@ -75,6 +75,9 @@ namespace tmssim {
      */
     double oldest(void) const;
 
+    /// @brief Writes the window, starting with the newest value
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
     //virtual UtilityAggregator* clone() const = 0;
     //virtual void write(xmlTextWriterPtr writer) const = 0;
     
@@ -29,6 +29,7 @@
  */
 
 #include <utility/uawmean.h>
+#include <core/steadystate.h>
 
 #include <xmlio/xmlutils.h>
 
@@ -91,4 +92,10 @@ namespace tmssim {
     return 0;
   }
 
+  bool UAWMean::writeState(StateSnapshot& snapshot) const {
+    snapshot.addValue(currentSum);
+    return UAWindow::writeState(snapshot);
+  }
+
+
 } // NS tmssim
@@ -51,6 +51,8 @@ namespace tmssim {
      */
     virtual UtilityAggregator* clone() const;
 
+    virtual bool writeState(StateSnapshot& snapshot) const;
+
 
     /**
      * @name XML
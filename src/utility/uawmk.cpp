@@ -29,6 +29,7 @@
  */
 
 #include <utility/uawmk.h>
+#include <core/steadystate.h>
 
 #include <xmlio/xmlutils.h>
 
@@ -102,4 +103,10 @@ namespace tmssim {
   }
 
 
+  bool UAWMK::writeState(StateSnapshot& snapshot) const {
+    snapshot.addValue(currentSum);
+    return UAWindow::writeState(snapshot);
+  }
+
+
 } // NS tmssim
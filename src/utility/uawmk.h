@@ -45,6 +45,7 @@ namespace tmssim {
 
     virtual void write(xmlTextWriterPtr writer) const;
     virtual UtilityAggregator* clone() const;
+    virtual bool writeState(StateSnapshot& snapshot) const;
     
 
     /**
@@ -0,0 +1,69 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file allocationcounter.cpp
+ * @brief Count the heap allocations of a thread
+ */
+
+#include <utils/allocationcounter.h>
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace tmssim {
+  namespace detail {
+    thread_local unsigned long allocationCount = 0;
+  } // NS detail
+} // NS tmssim
+
+
+/*
+ * Replacements of the global allocation functions, the array and
+ * sized variants of the library forward to these.
+ */
+
+void* operator new(std::size_t size) {
+  ++tmssim::detail::allocationCount;
+  void* p = std::malloc(size > 0 ? size : 1);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  ++tmssim::detail::allocationCount;
+  return std::malloc(size > 0 ? size : 1);
+}
+
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+#endif // COUNT_ALLOCATIONS
@@ -0,0 +1,67 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file allocationcounter.h
+ * @brief Count the heap allocations of a thread
+ */
+
+#ifndef UTILS_ALLOCATIONCOUNTER_H
+#define UTILS_ALLOCATIONCOUNTER_H 1
+
+namespace tmssim {
+
+#ifdef COUNT_ALLOCATIONS
+  namespace detail {
+    /// operator new calls of the current thread
+    extern thread_local unsigned long allocationCount;
+  } // NS detail
+#endif // COUNT_ALLOCATIONS
+
+  /**
+   * @brief Counts the calls of the global operator new in each thread
+   *
+   * Only available if tms-sim is built with -DCOUNT_ALLOCATIONS=1, which
+   * replaces the global operator new. Otherwise, the counter is always 0.
+   */
+  class AllocationCounter {
+  public:
+    /// @return true if allocations are counted
+    static bool isEnabled() {
+#ifdef COUNT_ALLOCATIONS
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /// @return number of allocations of the current thread so far
+    static unsigned long getCount() {
+#ifdef COUNT_ALLOCATIONS
+      return detail::allocationCount;
+#else
+      return 0;
+#endif
+    }
+  };
+
+} // NS tmssim
+
+#endif // !UTILS_ALLOCATIONCOUNTER_H
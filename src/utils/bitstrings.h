@@ -20,7 +20,7 @@
 /**
  * $Id: bitstrings.h 1358 2016-02-17 16:18:43Z klugeflo $
  * @file bitstrings.h
- * @brief Print bit strings
+ * @brief Print and query bit strings
  * @author Florian Kluge <kluge@informatik.uni-augsburg.de>
  */
 
@@ -31,6 +31,10 @@
 #include <cstdint>
 #include <string>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace tmssim {
 
   /**
@@ -52,6 +56,34 @@ namespace tmssim {
    * Print last length bits
    */
   std::string strBitString(uint32_t bits, size_t length=32);
+
+
+  /**
+   * Number of set bits
+   */
+  inline unsigned int countBits(uint64_t bits) {
+    return __builtin_popcountll(bits);
+  }
+
+
+  /**
+   * Position of the nth set bit, counted from the LSB
+   * @param bits the bit string
+   * @param n which set bit should be found, starting with 1
+   * @return the position (0 for the LSB), 64 if less than n bits are set
+   */
+  inline unsigned int selectBit(uint64_t bits, unsigned int n) {
+    if (n == 0 || n > 64)
+      return 64;
+#ifdef __BMI2__
+    uint64_t nth = _pdep_u64(1ULL << (n - 1), bits);
+#else
+    for (unsigned int i = 1; i < n && bits != 0; ++i)
+      bits &= bits - 1; // clear lowest set bit
+    uint64_t nth = bits & -bits;
+#endif
+    return nth == 0 ? 64 : __builtin_ctzll(nth);
+  }
   
   
 } // NS tmssim
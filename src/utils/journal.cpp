@@ -0,0 +1,136 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file journal.cpp
+ * @brief Append-only journal of completed results
+ */
+
+#include <utils/journal.h>
+#include <utils/tlogger.h>
+#include <utils/tmsexception.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace tmssim {
+
+  static string ioError(const string& what, const string& path) {
+    ostringstream oss;
+    oss << "Journal " << path << ": " << what << " failed: " << strerror(errno);
+    return oss.str();
+  }
+
+
+  Journal::Journal(const string& _path, bool resume, size_t _syncBatch,
+		   time_t _syncInterval)
+    : path(_path), fd(-1), syncBatch(_syncBatch > 0 ? _syncBatch : 1),
+      syncInterval(_syncInterval), nBuffered(0), lastSync(time(NULL))
+  {
+    int flags = O_WRONLY | O_CREAT | O_APPEND;
+    if (resume) {
+      readRecords();
+    }
+    else {
+      flags |= O_TRUNC;
+    }
+    fd = open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+      throw TMSException(ioError("open", path));
+    }
+  }
+
+
+  Journal::~Journal() {
+    try {
+      sync();
+    }
+    catch (TMSException& e) {
+      tError() << e.getMessage();
+    }
+    close(fd);
+  }
+
+
+  void Journal::append(const string& record) {
+    assert(record.find('\n') == string::npos);
+    buffer += record;
+    buffer += '\n';
+    ++nBuffered;
+    if (nBuffered >= syncBatch || time(NULL) - lastSync >= syncInterval) {
+      sync();
+    }
+  }
+
+
+  void Journal::sync() {
+    lastSync = time(NULL);
+    if (nBuffered == 0)
+      return;
+    const char* data = buffer.data();
+    size_t left = buffer.size();
+    while (left > 0) {
+      ssize_t n = write(fd, data, left);
+      if (n < 0) {
+	if (errno == EINTR)
+	  continue;
+	throw TMSException(ioError("write", path));
+      }
+      data += n;
+      left -= n;
+    }
+    if (fdatasync(fd) != 0) {
+      throw TMSException(ioError("fdatasync", path));
+    }
+    buffer.clear();
+    nBuffered = 0;
+  }
+
+
+  void Journal::readRecords() {
+    ifstream in(path);
+    if (!in.is_open()) // nothing to resume
+      return;
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    size_t valid = 0;
+    size_t nl;
+    while ((nl = content.find('\n', valid)) != string::npos) {
+      records.push_back(content.substr(valid, nl - valid));
+      valid = nl + 1;
+    }
+    if (valid < content.size()) {
+      tWarn() << "Journal " << path << ": discarding incomplete last record";
+      if (truncate(path.c_str(), valid) != 0) {
+	throw TMSException(ioError("truncate", path));
+      }
+    }
+  }
+
+} // NS tmssim
@@ -0,0 +1,92 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file journal.h
+ * @brief Append-only journal of completed results
+ */
+
+#ifndef UTILS_JOURNAL_H
+#define UTILS_JOURNAL_H 1
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Append-only journal for resuming long evaluations.
+   *
+   * Each record is a single line of text. Records are buffered and
+   * written to disk with fdatasync() after #syncBatch records or
+   * #syncInterval seconds, whichever comes first, and when the journal
+   * is destroyed. A program that is killed thus loses at most the
+   * records of the last batch. A partially written last line is
+   * discarded when the journal is reopened.
+   *
+   * On error, the methods throw a TMSException.
+   */
+  class Journal {
+  public:
+    /**
+     * @param _path journal file
+     * @param resume if true, read the records of an existing journal and
+     * append to it, otherwise start a new journal
+     * @param _syncBatch max. records that are not yet on disk
+     * @param _syncInterval max. seconds a record stays in the buffer
+     */
+    Journal(const std::string& _path, bool resume, size_t _syncBatch = 16,
+	    time_t _syncInterval = 60);
+
+    /// Writes all buffered records
+    ~Journal();
+
+    /// Records read on resume, in the order they were written
+    const std::vector<std::string>& getRecords() const { return records; }
+
+    /**
+     * @brief Append a record
+     * @param record must not contain newlines
+     */
+    void append(const std::string& record);
+
+    /**
+     * @brief Write all buffered records to disk
+     */
+    void sync();
+
+  private:
+    /// Read complete records, cut off a partially written last line
+    void readRecords();
+
+    std::string path;
+    int fd;
+    size_t syncBatch;
+    time_t syncInterval;
+    std::string buffer;
+    size_t nBuffered;
+    time_t lastSync;
+    std::vector<std::string> records;
+  };
+
+} // NS tmssim
+
+#endif // !UTILS_JOURNAL_H
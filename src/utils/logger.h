@@ -144,11 +144,11 @@ namespace tmssim {
 	myClass = cls;
 	if (myClass & globalClass) {
 	  buffer = new loutput_to_cout::stream_buffer;
+	  *buffer << "==" << LOG_PREFIX[bit2offset(cls)] << "== ";
 	}
 	else {
-	  buffer = new lno_output::stream_buffer;
+	  buffer = NULL;
 	}
-	*buffer << "==" << LOG_PREFIX[bit2offset(cls)] << "== ";
       }
 
       static void setClass(LogClass cls) {
@@ -160,17 +160,24 @@ namespace tmssim {
       static void deactivateClass(std::string cls);
       static LogClass getCurrentClass() { return llogger::globalClass; }
 
+      /**
+       * @brief Check whether output of a log class is enabled.
+       */
+      static bool isActive(LogClass cls) { return (cls & llogger::globalClass) != 0; }
+
       ~llogger() {
-	if (myClass & llogger::globalClass) {
+	if (buffer != NULL) {
 	  loutput_to_cout/*<Ch, Tr, A>*/()(*buffer);
+	  delete buffer;
 	}
-	delete buffer;
       }
 
     public:
       template<class T>
 	llogger &operator<<(const T &x) {
-	*buffer << x;
+	if (buffer != NULL) {
+	  *buffer << x;
+	}
 	return *this;
       }
     private:
@@ -204,10 +211,33 @@ namespace tmssim {
       friend class Guard;
 
     };
+
+    /**
+     * @brief Swallows a complete log statement, see #LOG
+     * idea plucked from glog's LogMessageVoidify
+     */
+    struct log_voidify {
+      void operator&(const llogger&) {}
+    };
   } // NS detail
 
   typedef detail::llogger/*<char, std::char_traits<char>, std::allocator<char> >*/ logger; 
-#define LOG(class) logger(class)
+
+  /**
+   * @brief Check whether a log class is enabled.
+   *
+   * Use this to guard the preparation of log output that is
+   * expensive, e.g. building strings in a loop.
+   */
+#define LOG_ACTIVE(class) (::tmssim::logger::isActive(class))
+
+  /**
+   * @brief Log to a class: LOG(LOG_CLASS_SCHEDULER) << "text" << value;
+   *
+   * If the class is not enabled, neither the logger is created nor are
+   * the arguments of the stream operators evaluated.
+   */
+#define LOG(class) !LOG_ACTIVE(class) ? (void) 0 : ::tmssim::detail::log_voidify() & ::tmssim::logger(class)
   
 } // NS tmssim
 
@@ -25,10 +25,13 @@
  * @author Florian Kluge <kluge@informatik.uni-augsburg.de>
  */
 
+#include <utils/mtpool.h>
+
+#include <condition_variable>
 #include <list>
-#include <thread>
 #include <mutex>
-#include <condition_variable>
+#include <thread>
+#include <vector>
 
 #include <iostream>
 
@@ -36,6 +39,15 @@ namespace tmssim {
 
   /**
    * Multithreaded simulation
+   *
+   * The workers take their work from a WorkStealingPool and hand over
+   * their results to the aggregator in batches (see MT_RESULT_BATCH).
+   * Define MT_LOCKFREE_RESULTS to use a lock-free result queue.
+   *
+   * The number of work items that were generated but not yet aggregated
+   * can be limited. The generator then waits until enough results were
+   * aggregated, so memory usage depends on the number of threads instead
+   * of the total amount of work.
    */
   template<class WorkClass, class ResultClass>
     class MtLgRunner {
@@ -52,17 +64,22 @@ namespace tmssim {
      * @param _aggregationFunction aggregates or outputs the results produced
      * by the worker threads.
      * @param _threads How many worker threads shall be run
+     * @param _maxInFlight How many work items may be generated but not yet
+     * aggregated before the generator is paused, 0 means no limit. As
+     * the generation function returns several items at once, the limit
+     * may be exceeded by one generated list.
      */
     MtLgRunner(GenerationFunction* _generationFunction,
 	     WorkFunction* _workFunction,
 	     AggregationFunction* _aggregationFunction,
-	     size_t _threads)
+	     size_t _threads, size_t _maxInFlight = 0)
       : generationFunction(_generationFunction),
       workFunction(_workFunction),
       aggregationFunction(_aggregationFunction),
       threads(_threads),
-      generationFinished(false),
-      workFinished(false)
+      maxInFlight(_maxInFlight),
+      inFlight(0),
+      workPool(_threads)
 	{
 	  tWorker = new std::thread[threads];
 	}
@@ -88,10 +105,7 @@ namespace tmssim {
       for (size_t i = 0; i < threads; ++i) {
 	tWorker[i].join();
       }
-      resultLock.lock();
-      workFinished = true;
-      resultCond.notify_all();
-      resultLock.unlock();
+      resultQueue.close();
       tAggregator.join();
 
     }
@@ -99,91 +113,67 @@ namespace tmssim {
 
   private:
 
-    void putWork(WorkClass* work) {
-      std::unique_lock<std::mutex> lck(workLock);
-      workPool.push_back(work);
-      workCond.notify_one();
-    }
-
-    
-    WorkClass* getWork() {
-      std::unique_lock<std::mutex> lck(workLock);
-      while (!generationFinished && workPool.size() == 0)
-	workCond.wait(lck);
-      WorkClass* work = NULL;
-      if (workPool.size() > 0) {
-	work = workPool.front();
-	workPool.pop_front();
-      }
-      else if (generationFinished) {
-	work = NULL;
-      }
-      else {
-	// should not happen
-	abort();
-      }
-      return work;
-    }
-
-    void putResult(ResultClass* result) {
-      std::unique_lock<std::mutex> lck(resultLock);
-      resultPool.push_back(result);
-      resultCond.notify_one();
-    }
-
-    
-    ResultClass* getResult() {
-      std::unique_lock<std::mutex> lck(resultLock);
-      while (!workFinished && resultPool.size() == 0)
-	resultCond.wait(lck);
-      ResultClass* result = NULL;
-      if (resultPool.size() > 0) {
-	result = resultPool.front();
-	resultPool.pop_front();
-      }
-      else if (workFinished) {
-	result = NULL;
-      }
-      else {
-	// should not happen
-	abort();
-      }
-      return result;
-    }
-
-
     void generationThread() {
       //std::cout << "G";
+      waitForWindow();
       std::list<WorkClass*> workList = generationFunction();
       while (workList.size() > 0) {
+	{
+	  std::lock_guard<std::mutex> lck(flightLock);
+	  inFlight += workList.size();
+	}
 	for (WorkClass* work: workList) {
-	  putWork(work);
+	  workPool.put(work);
 	}
+	waitForWindow();
 	workList = generationFunction();
       }
-      workLock.lock();
-      generationFinished = true;
-      workCond.notify_all();
-      workLock.unlock();
+      workPool.finish();
       //std::cout << "g";
     }
 
 
+    /// block the generator while too many work items are in flight
+    void waitForWindow() {
+      std::unique_lock<std::mutex> lck(flightLock);
+      while (maxInFlight > 0 && inFlight >= maxInFlight)
+	flightCond.wait(lck);
+    }
+
+
     void workThread(size_t tid) {
       //std::cout << "W";
-
-      while (WorkClass* work = getWork()) {
-	ResultClass* result = workFunction(tid, work);
-	putResult(result);
+      std::vector<ResultClass*> batch;
+      for (;;) {
+	WorkClass* work = workPool.tryGet(tid);
+	if (work == NULL) {
+	  // hand over results before waiting for new work
+	  resultQueue.push(batch);
+	  work = workPool.get(tid);
+	  if (work == NULL)
+	    break;
+	}
+	batch.push_back(workFunction(tid, work));
+	if (batch.size() >= MT_RESULT_BATCH)
+	  resultQueue.push(batch);
       }
+      resultQueue.push(batch);
       //std::cout << "w";
     }
 
     
     void aggregationThread() {
       //std::cout << "A";
-      while (ResultClass* result = getResult()) {
-	aggregationFunction(result);
+      std::list<ResultClass*> results;
+      while (resultQueue.pop(results)) {
+	for (ResultClass* result: results) {
+	  aggregationFunction(result);
+	  std::lock_guard<std::mutex> lck(flightLock);
+	  --inFlight;
+	  if (inFlight < maxInFlight)
+	    flightCond.notify_one();
+	}
+	results.clear();
       }
       //std::cout << "a";
     }
@@ -194,22 +184,19 @@ namespace tmssim {
     WorkFunction* workFunction;
     AggregationFunction* aggregationFunction;
     size_t threads;
+
+    size_t maxInFlight;
+    size_t inFlight; ///< generated, but not yet aggregated work items
+    std::mutex flightLock;
+    std::condition_variable flightCond;
     
-    std::list<WorkClass*> workPool;
-    std::list<ResultClass*> resultPool;
+    WorkStealingPool<WorkClass> workPool;
+    ResultQueue<ResultClass> resultQueue;
 
     std::thread tGenerator;
     std::thread* tWorker;
     std::thread tAggregator;
 
-    bool generationFinished;
-    std::mutex workLock;
-    std::condition_variable workCond;
-
-    bool workFinished;
-    std::mutex resultLock;
-    std::condition_variable resultCond;
-
   };
 
   //template<class WorkClass, class ResultClass>
@@ -0,0 +1,320 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file mtpool.h
+ * @brief Work distribution and result collection for MtRunner and
+ *        MtLgRunner
+ */
+
+#ifndef UTILS_MTPOOL_H
+#define UTILS_MTPOOL_H 1
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace tmssim {
+
+  /**
+   * @brief Work pool with one deque per worker thread.
+   *
+   * New work is distributed round-robin over the workers' deques. Each
+   * worker takes work from the front of its own deque; if that is empty,
+   * it steals from the back of the other workers' deques. Thus, workers
+   * only contend for a lock if they access the same deque. Workers only
+   * block on the shared condition variable if no work is available at all.
+   */
+  template<class WorkClass>
+    class WorkStealingPool {
+  public:
+    /**
+     * @param _workers number of worker threads
+     */
+    WorkStealingPool(size_t _workers)
+      : workers(_workers > 0 ? _workers : 1), queues(workers), next(0), pending(0),
+      sleepers(0), finished(false)
+    {
+    }
+
+    /**
+     * @brief Add work, must only be called by a single generator thread
+     */
+    void put(WorkClass* work) {
+      Queue& q = queues[next];
+      next = (next + 1) % workers;
+      {
+	std::lock_guard<std::mutex> lck(q.lock);
+	q.work.push_back(work);
+	// count under the lock, so no worker can take the work before
+	++pending;
+      }
+      if (sleepers > 0) {
+	std::lock_guard<std::mutex> lck(idleLock);
+	idleCond.notify_one();
+      }
+    }
+
+    /**
+     * @brief Signal that no more work will be added
+     */
+    void finish() {
+      std::lock_guard<std::mutex> lck(idleLock);
+      finished = true;
+      idleCond.notify_all();
+    }
+
+    /**
+     * @brief Get work without blocking
+     * @param tid the worker's id
+     * @return the work, NULL if none is available right now
+     */
+    WorkClass* tryGet(size_t tid) {
+      if (pending == 0)
+	return NULL;
+      WorkClass* work = NULL;
+      for (size_t i = 0; i < workers && work == NULL; ++i) {
+	Queue& q = queues[(tid + i) % workers];
+	std::lock_guard<std::mutex> lck(q.lock);
+	if (q.work.empty())
+	  continue;
+	if (i == 0) { // own queue
+	  work = q.work.front();
+	  q.work.pop_front();
+	}
+	else {
+	  work = q.work.back();
+	  q.work.pop_back();
+	}
+      }
+      if (work != NULL)
+	--pending;
+      return work;
+    }
+
+    /**
+     * @brief Get work, block until work is available
+     * @param tid the worker's id
+     * @return the work, NULL if all work is done
+     */
+    WorkClass* get(size_t tid) {
+      for (;;) {
+	WorkClass* work = tryGet(tid);
+	if (work != NULL)
+	  return work;
+	std::unique_lock<std::mutex> lck(idleLock);
+	++sleepers;
+	while (pending == 0 && !finished)
+	  idleCond.wait(lck);
+	--sleepers;
+	if (pending == 0 && finished)
+	  return NULL;
+      }
+    }
+
+  private:
+    struct Queue {
+      std::mutex lock;
+      std::deque<WorkClass*> work;
+    };
+
+    size_t workers;
+    std::vector<Queue> queues;
+    size_t next; ///< queue for the next work, only used by the generator
+
+    std::atomic<size_t> pending; ///< work items in all queues
+    std::atomic<size_t> sleepers; ///< workers waiting for #idleCond
+    bool finished;
+    std::mutex idleLock;
+    std::condition_variable idleCond;
+  };
+
+
+#ifdef MT_LOCKFREE_RESULTS
+
+  /**
+   * @brief Lock-free multi-producer single-consumer queue of result
+   * batches.
+   *
+   * Producers push whole batches onto a lock-free stack. The consumer
+   * takes the complete stack at once and reverses it, so batches are
+   * consumed in the order they were pushed. The mutex is only used
+   * to put the consumer to sleep if the queue is empty.
+   */
+  template<class ResultClass>
+    class ResultQueue {
+  public:
+    ResultQueue()
+      : head(NULL), waiting(false), closed(false) {
+    }
+
+    ~ResultQueue() {
+      Node* node = head.exchange(NULL);
+      while (node != NULL) {
+	Node* n = node->next;
+	delete node;
+	node = n;
+      }
+    }
+
+    /**
+     * @brief Hand over a batch of results, the batch is cleared
+     */
+    void push(std::vector<ResultClass*>& batch) {
+      if (batch.empty())
+	return;
+      Node* node = new Node;
+      node->results.swap(batch);
+      node->next = head.load();
+      while (!head.compare_exchange_weak(node->next, node))
+	;
+      if (waiting) {
+	std::lock_guard<std::mutex> lck(lock);
+	cond.notify_one();
+      }
+    }
+
+    /**
+     * @brief Signal that no more results will be pushed
+     */
+    void close() {
+      std::lock_guard<std::mutex> lck(lock);
+      closed = true;
+      cond.notify_all();
+    }
+
+    /**
+     * @brief Take all available results, block until results are available
+     * @param[out] results the results in order of their batches
+     * @return false, if the queue is closed and empty
+     */
+    bool pop(std::list<ResultClass*>& results) {
+      Node* node = head.exchange(NULL);
+      if (node == NULL) {
+	std::unique_lock<std::mutex> lck(lock);
+	waiting = true;
+	while ((node = head.exchange(NULL)) == NULL && !closed)
+	  cond.wait(lck);
+	waiting = false;
+	if (node == NULL)
+	  return false;
+      }
+      // reverse stack to get the batches in FIFO order
+      Node* fifo = NULL;
+      while (node != NULL) {
+	Node* n = node->next;
+	node->next = fifo;
+	fifo = node;
+	node = n;
+      }
+      while (fifo != NULL) {
+	results.insert(results.end(), fifo->results.begin(), fifo->results.end());
+	Node* n = fifo->next;
+	delete fifo;
+	fifo = n;
+      }
+      return true;
+    }
+
+  private:
+    struct Node {
+      std::vector<ResultClass*> results;
+      Node* next;
+    };
+
+    std::atomic<Node*> head;
+    std::atomic<bool> waiting; ///< consumer waits for #cond
+    bool closed;
+    std::mutex lock;
+    std::condition_variable cond;
+  };
+
+#else // !MT_LOCKFREE_RESULTS
+
+  /**
+   * @brief Multi-producer single-consumer queue of result batches
+   */
+  template<class ResultClass>
+    class ResultQueue {
+  public:
+    ResultQueue()
+      : closed(false) {
+    }
+
+    /**
+     * @brief Hand over a batch of results, the batch is cleared
+     */
+    void push(std::vector<ResultClass*>& batch) {
+      if (batch.empty())
+	return;
+      std::lock_guard<std::mutex> lck(lock);
+      results.insert(results.end(), batch.begin(), batch.end());
+      cond.notify_one();
+      batch.clear();
+    }
+
+    /**
+     * @brief Signal that no more results will be pushed
+     */
+    void close() {
+      std::lock_guard<std::mutex> lck(lock);
+      closed = true;
+      cond.notify_all();
+    }
+
+    /**
+     * @brief Take all available results, block until results are available
+     * @param[out] _results the results in order of their batches
+     * @return false, if the queue is closed and empty
+     */
+    bool pop(std::list<ResultClass*>& _results) {
+      std::unique_lock<std::mutex> lck(lock);
+      while (results.empty() && !closed)
+	cond.wait(lck);
+      if (results.empty())
+	return false;
+      _results.splice(_results.end(), results);
+      return true;
+    }
+
+  private:
+    std::list<ResultClass*> results;
+    bool closed;
+    std::mutex lock;
+    std::condition_variable cond;
+  };
+
+#endif // MT_LOCKFREE_RESULTS
+
+
+  /**
+   * Number of results a worker collects before it hands them over to
+   * the aggregator. A worker also hands over its results before it
+   * waits for new work.
+   */
+#define MT_RESULT_BATCH 16
+
+} // NS tmssim
+
+#endif /* !UTILS_MTPOOL_H */
@@ -24,10 +24,11 @@
  * @author Florian Kluge <kluge@informatik.uni-augsburg.de>
  */
 
+#include <utils/mtpool.h>
+
 #include <list>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
+#include <vector>
 
 #include <iostream>
 
@@ -35,6 +36,10 @@ namespace tmssim {
 
   /**
    * Multithreaded simulation
+   *
+   * The workers take their work from a WorkStealingPool and hand over
+   * their results to the aggregator in batches (see MT_RESULT_BATCH).
+   * Define MT_LOCKFREE_RESULTS to use a lock-free result queue.
    */
   template<class WorkClass, class ResultClass>
     class MtRunner {
@@ -60,8 +65,7 @@ namespace tmssim {
       workFunction(_workFunction),
       aggregationFunction(_aggregationFunction),
       threads(_threads),
-      generationFinished(false),
-      workFinished(false)
+      workPool(_threads)
 	{
 	  tWorker = new std::thread[threads];
 	}
@@ -77,7 +81,7 @@ namespace tmssim {
     void run() {
       tGenerator = std::thread(&MtRunner::generationThread, this);
       for (size_t i = 0; i < threads; ++i) {
-	tWorker[i] = std::thread(&MtRunner::workThread, this);
+	tWorker[i] = std::thread(&MtRunner::workThread, this, i);
       }
       tAggregator = std::thread(&MtRunner::aggregationThread, this);
 
@@ -85,10 +89,7 @@ namespace tmssim {
       for (size_t i = 0; i < threads; ++i) {
 	tWorker[i].join();
       }
-      resultLock.lock();
-      workFinished = true;
-      resultCond.notify_all();
-      resultLock.unlock();
+      resultQueue.close();
       tAggregator.join();
 
     }
@@ -96,87 +97,45 @@ namespace tmssim {
 
   private:
 
-    void putWork(WorkClass* work) {
-      std::unique_lock<std::mutex> lck(workLock);
-      workPool.push_back(work);
-      workCond.notify_one();
-    }
-
-    
-    WorkClass* getWork() {
-      std::unique_lock<std::mutex> lck(workLock);
-      while (!generationFinished && workPool.size() == 0)
-	workCond.wait(lck);
-      WorkClass* work = NULL;
-      if (workPool.size() > 0) {
-	work = workPool.front();
-	workPool.pop_front();
-      }
-      else if (generationFinished) {
-	work = NULL;
-      }
-      else {
-	// should not happen
-	abort();
-      }
-      return work;
-    }
-
-    void putResult(ResultClass* result) {
-      std::unique_lock<std::mutex> lck(resultLock);
-      resultPool.push_back(result);
-      resultCond.notify_one();
-    }
-
-    
-    ResultClass* getResult() {
-      std::unique_lock<std::mutex> lck(resultLock);
-      while (!workFinished && resultPool.size() == 0)
-	resultCond.wait(lck);
-      ResultClass* result = NULL;
-      if (resultPool.size() > 0) {
-	result = resultPool.front();
-	resultPool.pop_front();
-      }
-      else if (workFinished) {
-	result = NULL;
-      }
-      else {
-	// should not happen
-	abort();
-      }
-      return result;
-    }
-
-
     void generationThread() {
       //std::cout << "G";
       while (WorkClass* work = generationFunction()) {
-	putWork(work);
+	workPool.put(work);
       }
-      workLock.lock();
-      generationFinished = true;
-      workCond.notify_all();
-      workLock.unlock();
+      workPool.finish();
       //std::cout << "g";
     }
 
 
-    void workThread() {
+    void workThread(size_t tid) {
       //std::cout << "W";
-
-      while (WorkClass* work = getWork()) {
-	ResultClass* result = workFunction(work);
-	putResult(result);
+      std::vector<ResultClass*> batch;
+      for (;;) {
+	WorkClass* work = workPool.tryGet(tid);
+	if (work == NULL) {
+	  // hand over results before waiting for new work
+	  resultQueue.push(batch);
+	  work = workPool.get(tid);
+	  if (work == NULL)
+	    break;
+	}
+	batch.push_back(workFunction(work));
+	if (batch.size() >= MT_RESULT_BATCH)
+	  resultQueue.push(batch);
       }
+      resultQueue.push(batch);
       //std::cout << "w";
     }
 
     
     void aggregationThread() {
       //std::cout << "A";
-      while (ResultClass* result = getResult()) {
-	aggregationFunction(result);
+      std::list<ResultClass*> results;
+      while (resultQueue.pop(results)) {
+	for (ResultClass* result: results) {
+	  aggregationFunction(result);
+	}
+	results.clear();
       }
       //std::cout << "a";
     }
@@ -188,21 +147,13 @@ namespace tmssim {
     AggregationFunction* aggregationFunction;
     size_t threads;
     
-    std::list<WorkClass*> workPool;
-    std::list<ResultClass*> resultPool;
+    WorkStealingPool<WorkClass> workPool;
+    ResultQueue<ResultClass> resultQueue;
 
     std::thread tGenerator;
     std::thread* tWorker;
     std::thread tAggregator;
 
-    bool generationFinished;
-    std::mutex workLock;
-    std::condition_variable workCond;
-
-    bool workFinished;
-    std::mutex resultLock;
-    std::condition_variable resultCond;
-
   };
 
   //template<class WorkClass, class ResultClass>
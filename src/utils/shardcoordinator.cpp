@@ -0,0 +1,215 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file shardcoordinator.cpp
+ * @brief Run an evaluation in several worker processes
+ */
+
+#include <utils/shardcoordinator.h>
+#include <utils/tlogger.h>
+#include <utils/tmsexception.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace tmssim {
+
+  static string sysError(const string& what) {
+    ostringstream oss;
+    oss << "ShardCoordinator: " << what << " failed: " << strerror(errno);
+    return oss.str();
+  }
+
+
+  ShardCoordinator::ShardCoordinator(unsigned _nShards)
+    : nShards(_nShards > 0 ? _nShards : 1), shard(-1)
+  {
+  }
+
+
+  ShardCoordinator::~ShardCoordinator() {
+    for (int fd: fds) {
+      if (fd >= 0)
+	close(fd);
+    }
+  }
+
+
+  int ShardCoordinator::fork() {
+    assert(pids.empty());
+    for (unsigned i = 0; i < nShards; ++i) {
+      int p[2];
+      if (pipe(p) != 0) {
+	int err = errno;
+	abortWorkers();
+	errno = err;
+	throw TMSException(sysError("pipe"));
+      }
+      pid_t pid = ::fork();
+      if (pid < 0) {
+	int err = errno;
+	close(p[0]);
+	close(p[1]);
+	abortWorkers();
+	errno = err;
+	throw TMSException(sysError("fork"));
+      }
+      if (pid == 0) {
+	// worker: keep only the write end of its own pipe
+	for (int fd: fds) {
+	  close(fd);
+	}
+	close(p[0]);
+	fds.assign(nShards, -1);
+	fds[i] = p[1];
+	pids.clear();
+	shard = i;
+	return shard;
+      }
+      close(p[1]);
+      pids.push_back(pid);
+      fds.push_back(p[0]);
+    }
+    return -1;
+  }
+
+
+  void ShardCoordinator::send(const string& record) {
+    assert(shard >= 0);
+    assert(record.find('\n') == string::npos);
+    string line = record + '\n';
+    const char* data = line.data();
+    size_t left = line.size();
+    while (left > 0) {
+      ssize_t n = write(fds[shard], data, left);
+      if (n < 0) {
+	if (errno == EINTR)
+	  continue;
+	throw TMSException(sysError("write"));
+      }
+      data += n;
+      left -= n;
+    }
+  }
+
+
+  void ShardCoordinator::finishWorker() {
+    assert(shard >= 0);
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+    close(fds[shard]);
+    _exit(0);
+  }
+
+
+  unsigned ShardCoordinator::collect(RecordFunction* handler) {
+    assert(shard < 0);
+    vector<string> buffers(pids.size());
+    vector<struct pollfd> pfds(pids.size());
+    unsigned open = pids.size();
+    unsigned failed = 0;
+    char buf[4096];
+
+    while (open > 0) {
+      for (size_t i = 0; i < pids.size(); ++i) {
+	pfds[i].fd = fds[i]; // poll ignores negative fds
+	pfds[i].events = POLLIN;
+	pfds[i].revents = 0;
+      }
+      if (poll(pfds.data(), pfds.size(), -1) < 0) {
+	if (errno == EINTR)
+	  continue;
+	throw TMSException(sysError("poll"));
+      }
+
+      for (size_t i = 0; i < pids.size(); ++i) {
+	if (pfds[i].revents == 0)
+	  continue;
+	ssize_t n = read(fds[i], buf, sizeof(buf));
+	if (n < 0) {
+	  if (errno == EINTR)
+	    continue;
+	  throw TMSException(sysError("read"));
+	}
+	if (n > 0) {
+	  buffers[i].append(buf, n);
+	  size_t start = 0;
+	  size_t nl;
+	  while ((nl = buffers[i].find('\n', start)) != string::npos) {
+	    handler(buffers[i].substr(start, nl - start));
+	    start = nl + 1;
+	  }
+	  buffers[i].erase(0, start);
+	  continue;
+	}
+
+	// end of file: the worker has terminated
+	close(fds[i]);
+	fds[i] = -1;
+	--open;
+	int status;
+	while (waitpid(pids[i], &status, 0) < 0) {
+	  if (errno != EINTR)
+	    throw TMSException(sysError("waitpid"));
+	}
+	if (WIFSIGNALED(status)) {
+	  tError() << "Shard " << i << " (pid " << pids[i]
+		   << ") was terminated by signal " << WTERMSIG(status);
+	  ++failed;
+	}
+	else if (WEXITSTATUS(status) != 0) {
+	  tError() << "Shard " << i << " (pid " << pids[i]
+		   << ") exited with status " << WEXITSTATUS(status);
+	  ++failed;
+	}
+	if (!buffers[i].empty()) {
+	  tWarn() << "Shard " << i << ": discarding incomplete last record";
+	}
+      }
+    }
+    pids.clear();
+    return failed;
+  }
+
+
+  void ShardCoordinator::abortWorkers() {
+    for (size_t i = 0; i < pids.size(); ++i) {
+      kill(pids[i], SIGTERM);
+      close(fds[i]);
+      waitpid(pids[i], NULL, 0);
+    }
+    pids.clear();
+    fds.clear();
+  }
+
+} // NS tmssim
@@ -0,0 +1,105 @@
+/*
+ * This file is part of tms-sim.
+ *
+ * Copyright 2014 University of Augsburg
+ *
+ * tms-sim is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tms-sim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tms-sim.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * $Id$
+ * @file shardcoordinator.h
+ * @brief Run an evaluation in several worker processes
+ */
+
+#ifndef UTILS_SHARDCOORDINATOR_H
+#define UTILS_SHARDCOORDINATOR_H 1
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace tmssim {
+
+  /**
+   * @brief Splits an evaluation over several processes on the local host.
+   *
+   * fork() creates the worker processes, each of them is connected to
+   * the coordinator by a pipe. A worker simulates its part of the work
+   * and sends one line of text per result with send(); the coordinator
+   * merges the results of all workers in collect(). Compared to a
+   * single process with many threads, the workers do not share a heap
+   * or locks, and a crash only loses the unfinished results of one
+   * worker.
+   *
+   * The workers are forked, so fork() must be called before any thread
+   * is started, and all C++ streams should be flushed before.
+   *
+   * On error, the methods throw a TMSException.
+   */
+  class ShardCoordinator {
+    typedef void (RecordFunction)(const std::string&);
+
+  public:
+    /**
+     * @param _nShards number of worker processes
+     */
+    ShardCoordinator(unsigned _nShards);
+
+    ~ShardCoordinator();
+
+    unsigned getNShards() const { return nShards; }
+
+    /**
+     * @brief Start the worker processes
+     * @return the index of the shard in a worker, -1 in the coordinator
+     */
+    int fork();
+
+    /**
+     * @brief Send a result from a worker to the coordinator
+     * @param record must not contain newlines
+     */
+    void send(const std::string& record);
+
+    /**
+     * @brief Terminate a worker process after its last result, does
+     * not return. Destructors of global objects are not run, so the
+     * worker does not touch files that belong to the coordinator.
+     */
+    void finishWorker();
+
+    /**
+     * @brief Receive results until all workers have terminated
+     * @param handler is called in the coordinator for each record
+     * @return number of workers that crashed or failed
+     */
+    unsigned collect(RecordFunction* handler);
+
+  private:
+    /// Kill and reap all workers that were already started
+    void abortWorkers();
+
+    unsigned nShards;
+    /// index of this process, -1 for the coordinator
+    int shard;
+    std::vector<pid_t> pids;
+    /// coordinator: read ends of the pipes; worker: write end at #shard
+    std::vector<int> fds;
+  };
+
+} // NS tmssim
+
+#endif // !UTILS_SHARDCOORDINATOR_H
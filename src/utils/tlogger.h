@@ -108,6 +108,12 @@ namespace tmssim {
 #define TLOGLEVEL TLL_WARN
 #endif
 
+  /**
+   * @brief Compile-time check whether a log level is enabled, use to
+   * guard expensive preparation of tDebug etc. output
+   */
+#define TLOG_ACTIVE(level) (TLOGLEVEL >= (level))
+
 
 #if TLOGLEVEL >= TLL_ERROR
   class tError : public detail::tlogger<detail::output_to_clog> {